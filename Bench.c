@@ -0,0 +1,578 @@
+// Synthetic Workload Benchmark version 0.5.1 
+/* Release Notes: 
+
+		<0.5.1 > 261019 Percentiles come from Sched_Pct, 0 for a run without releases. 
+										Check skips baseline entries that failed themselves. 
+		<0.5.0 > 261019 Added Spawn: OS_New and OS_Del latency with and without the recycle bins of Lin. 
+		<0.4.0 > 261019 Added Msg: throughput of single against batched messaging. 
+		<0.3.0 > 261019 Added Check and Regress: baseline comparison with a pass or fail verdict. 
+										Sweep returns Bench_Fail for a run that could not be set up instead of wrapping the total. 
+										Run keeps to Duration when woken by Generic Events. 
+		<0.2.0 > 261019 Added Seq: published state against a critical region. 
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	Runs a synthetic task set on the real kernel and reports how well it was served, 
+	so scheduler changes can be compared by numbers rather than by Sched_DebugSchedTimes. 
+
+	A periodic task (Period > 0) is released by its TBG, burns Wcet us of CPU 
+	and sends FanOut messages to the sporadic tasks of the set. 
+	A sporadic task (Period == 0) burns Wcet us for each message it receives, 
+	from periodic tasks or from Bench_Isr, which stands for an interrupt. 
+	Response times are measured from the release, or from the send of the message, 
+	to the end of the work, and a deadline is missed when one exceeds Deadline. 
+	Releases skipped by an overrunning periodic task count as misses too. 
+
+	Usage, from a task: 
+		Bench_Report Rep[Bench_Pols * 3]; 
+		u32 Misses = Bench_Sweep(8, 10000, Rep, 1); 	// 8 tasks, 10 s per run 
+	or with a hand made set: 
+		Bench_Spec Spec[3] = { 
+			{1000, 200, 0, 1, 1}, 		// 1 ms period, 200 us, sends one message per release 
+			{5000, 1500, 0, 2, 0}, 
+			{0, 100, 2000, 0, 0}, 		// Sporadic, 2 ms deadline 
+		}; 
+		Bench_Run(Spec, 3, 500, 10000, &Rep[0]); 	// Plus 500 interrupts per second 
+
+	Bench_Seq times Seq_Read and Seq_Write against the same copy under a critical region, 
+	then reads for Duration ms while the timer task publishes every millisecond: 
+		Bench_SeqReport R; 
+		Bench_Seq(32, 1000, &R); 
+	Run it from a task below Tmr_TaskPri, or the timer never preempts the reader. 
+
+	Bench_Msg times bursts of Burst Messages the calling task sends to itself and receives, 
+	one call per Message against one call per burst: 
+		Bench_MsgReport M; 
+		Bench_Msg(16, &M); 	// M.SendOne + M.RecvOne against M.SendN + M.RecvN 
+	The mailbox of the caller must be empty and may not be bounded below Burst. 
+
+	Bench_Spawn creates and deletes batches of Bench_SpawnBatch tasks that never run, and 
+	files every call by whether a recycle bin of Lin served it, so one run gives the heap 
+	path and the recycled path side by side: 
+		Bench_SpawnReport S; 
+		Bench_Spawn(512, &S); 	// S.NewFresh against S.NewRecy 
+	With Lin_StkPaint the fresh path includes painting the stack, the recycled path does not. 
+
+	The calling task is raised to Bench_RunPri for the run and restored afterwards. 
+
+	Regression gate: Bench_Regress runs Bench_Sweep with a fixed seed and prints every 
+	report as a C initializer. Stored in the application, that output is the baseline: 
+		static const Bench_Report Base[] = { ... }; 	// Printed by a run with Base NULL 
+		Bench_Report Rep[Bench_Pols * 3]; 
+		int Bad = Bench_Regress(8, 2000, 1, Base, Rep); 	// 0 on a pass 
+	A report regresses when it fails to run, misses more than Bench_TolMiss extra deadlines, 
+	its P99 moves up more than Bench_TolBkt buckets or the scheduler share grows more than 
+	Bench_TolPm. A baseline entry that failed is not compared. 
+	With Bench_Semi 1 the output goes through semihosting, ending in PASS or FAIL, 
+	and a QEMU started with -semihosting exits with the number of regressions as its status: 
+		qemu-system-arm -M <board> -nographic -semihosting -kernel app.elf 
+	The stored baseline only holds for the board, clock and build it was printed from. 
+*/
+#include <OS.h> 
+#include "Bench.h" 
+
+extern u32 Lin_DebugCtxSwTimes; 
+extern u32 Sched_DebugSchedTimes; 
+extern u32 Lin_RecyCnt[Lin_RecyBins]; 
+
+#define Bench_Cmd 	0x42454E43 	// Messages of sporadic work 
+
+// Task State 
+typedef struct Bench_Blk{ 
+	Bench_Spec Spec; 
+	TASK Task; 
+	u32 Release; 			// Last release, for skipped releases 
+}Bench_Blk; 
+
+Bench_Blk Bench_Tasks[Bench_TaskMax]; 
+int Bench_TaskCnt; 
+int Bench_Sinks[Bench_TaskMax]; 	// Sporadic tasks of the set 
+int Bench_SinkCnt; 
+int Bench_SinkNext; 
+u32 Bench_LoopsQ8; 						// Burn loops per us, Q8 
+u32 Bench_RandState; 
+u32 Bench_IsrRate; 
+u32 Bench_IsrAcc; 
+
+u32 Bench_Hist[Bench_Buckets]; 
+u32 Bench_Releases; 
+u32 Bench_Misses; 
+u32 Bench_Max; 
+
+u32 Bench_Rand(void){ 	// Linear congruential, seeded by Bench_Gen. 
+	Bench_RandState = Bench_RandState * 1664525 + 1013904223; 
+	return Bench_RandState >> 8; 
+}
+
+static void Bench_Calibrate(void){ 	// Measure the burn loop against the cycle counter. 
+	__critical_enter(); 
+	u32 Start = Lin_CycCnt(); 
+	for(volatile u32 i = 0; i < 1024; i++); 
+	u32 Cyc = Lin_CycCnt() - Start; 
+	__critical_exit(); 
+	if(Cyc == 0) Cyc = 1; 
+	Bench_LoopsQ8 = (SystemCoreClock / 1000000) * 1024 * 256 / Cyc; 
+}
+
+void Bench_Burn(u32 Us){ 	// Spend Us of CPU time. Preemption does not shorten it. 
+	u32 Loops = (Us * Bench_LoopsQ8) >> 8; 
+	for(volatile u32 i = 0; i < Loops; i++); 
+}
+
+static int Bench_Bucket(u32 Us){ 
+	int n = 0; 
+	while(Us != 0 && n < Bench_Buckets - 1){ 
+		Us >>= 1; 
+		n++; 
+	}
+	return n; 
+}
+
+static void Bench_Record(u32 Resp, u32 Deadline, u32 Skipped){ 
+	__critical_enter(); 
+	Bench_Hist[Bench_Bucket(Resp)]++; 
+	Bench_Releases++; 
+	if(Deadline != 0 && Resp > Deadline) Bench_Misses++; 
+	Bench_Misses += Skipped; 
+	if(Resp > Bench_Max) Bench_Max = Resp; 
+	__critical_exit(); 
+}
+
+static void Bench_Send(void){ 	// One message to the next sporadic task, stamped with the send time. 
+	__critical_enter(); 
+	if(Bench_SinkCnt == 0){ 
+		__critical_exit(); 
+		return; 
+	}
+	TASK Task = Bench_Tasks[Bench_Sinks[Bench_SinkNext]].Task; 
+	if(++Bench_SinkNext >= Bench_SinkCnt) Bench_SinkNext = 0; 
+	__critical_exit(); 
+	MSG Msg; 
+	Msg.Src = 0; 
+	Msg.Cmd = Bench_Cmd; 
+	Msg.Pld = (void *)OS_TimeStamp(); 
+	if(Task == NULL || OS_TxMsg(Task, Msg) != 0){ 	// Lost work is a miss. 
+		Bench_Record(0, 0, 1); 
+		return; 
+	}
+	OS_GenEvent(Task, 0); 
+}
+
+void Bench_Isr(void){ 	// An interrupt worth of sporadic work. ISR safe. 
+	Bench_Send(); 
+}
+
+static void Bench_Tick(void * Arg){ 	// Software timer standing in for interrupts at Bench_IsrRate per second. 
+	Bench_IsrAcc += Bench_IsrRate; 
+	while(Bench_IsrAcc >= 1000){ 
+		Bench_IsrAcc -= 1000; 
+		Bench_Isr(); 
+	}
+}
+
+static void Bench_Task(TASK Self, int Index){ 
+	Bench_Blk * Blk = &Bench_Tasks[Index]; 
+	const Bench_Spec * Spec = &Blk->Spec; 
+	u32 Deadline = Spec->Deadline ? Spec->Deadline : Spec->Period; 
+	if(Spec->Period == 0){ 	// Sporadic 
+		for(;;){ 
+			while(OS_RxCnt() == 0) OS_Suspend(); 
+			MSG Msg = OS_RxMsg(); 
+			if(Msg.Cmd != Bench_Cmd) continue; 
+			Bench_Burn(Spec->Wcet); 
+			Bench_Record(OS_TimeStamp() - (u32)Msg.Pld, Deadline, 0); 
+		}
+	}
+	OS_TBGperiodUs(Spec->Period); 
+	Blk->Release = Self->ECB->TimeBase_Stamp - Spec->Period; 
+	for(;;){ 
+		OS_Suspend(); 
+		if(Self->WkupSrc != Src_TBG) continue; 
+		u32 Release = Self->ECB->TimeBase_Stamp - Spec->Period; 	// Already advanced by the scheduler. 
+		u32 Gap = Release - Blk->Release; 
+		u32 Skipped = (Gap >= 2 * Spec->Period) ? Gap / Spec->Period - 1 : 0; 
+		Blk->Release = Release; 
+		Bench_Burn(Spec->Wcet); 
+		for(int i = 0; i < Spec->FanOut; i++) Bench_Send(); 
+		Bench_Record(OS_TimeStamp() - Release, Deadline, Skipped); 
+	}
+}
+
+int Bench_Gen(Bench_Spec * Spec, int N, u32 Util, int Policy, u32 Seed){ 	// Random periodic set with a total utilization in permille. Returns N. 
+	static const u32 Periods[] = {1000, 2000, 5000, 10000, 20000, 50000, 100000}; 
+	u32 Weight[Bench_TaskMax]; 
+	u32 Sum = 0; 
+	if(N > Bench_TaskMax) N = Bench_TaskMax; 
+	Bench_RandState = Seed; 
+	for(int i = 0; i < N; i++){ 
+		Weight[i] = Bench_Rand() % 1000 + 1; 
+		Sum += Weight[i]; 
+	}
+	for(int i = 0; i < N; i++){ 
+		Spec[i].Period = Periods[Bench_Rand() % (sizeof(Periods) / sizeof(Periods[0]))]; 
+		Spec[i].Wcet = (u32)((unsigned long long)Spec[i].Period * Util * Weight[i] / Sum / 1000); 
+		Spec[i].Deadline = 0; 
+		Spec[i].FanOut = 0; 
+		if(Policy == Bench_PolRand) Spec[i].Priority = Bench_Rand() % N; 
+		else Spec[i].Priority = 0; 
+	}
+	if(Policy == Bench_PolRM){ 	// Rank by period. 
+		for(int i = 0; i < N; i++){ 
+			int Rank = 0; 
+			for(int j = 0; j < N; j++) if(Spec[j].Period < Spec[i].Period) Rank++; 
+			Spec[i].Priority = Rank; 
+		}
+	}
+	return N; 
+}
+
+int Bench_Run(const Bench_Spec * Spec, int N, u32 IsrRate, u32 Duration, Bench_Report * Rep){ 	// Run a set for Duration ms. Returns 0, or -1 if it could not be set up. 
+	if(N > Bench_TaskMax) return -1; 
+	TASK Self = Lin_GetCurrTask(); 
+	int Pri = Self->Priority; 
+	OS_ChgPri(Self, Bench_RunPri); 
+	Bench_Calibrate(); 
+	for(int i = 0; i < Bench_Buckets; i++) Bench_Hist[i] = 0; 
+	Bench_Releases = 0; 
+	Bench_Misses = 0; 
+	Bench_Max = 0; 
+	Bench_SinkCnt = 0; 
+	Bench_SinkNext = 0; 
+	Bench_TaskCnt = 0; 
+	int Ret = 0; 
+	for(int i = 0; i < N; i++){ 
+		Bench_Blk * Blk = &Bench_Tasks[i]; 
+		Blk->Spec = Spec[i]; 
+		Blk->Task = OS_New(Bench_StkSize, Bench_Task); 
+		if(Blk->Task == NULL){ 
+			Ret = -1; 
+			break; 
+		}
+		Bench_TaskCnt++; 
+		Lin_SetArgs(Blk->Task, i, 0); 
+		OS_ChgPri(Blk->Task, Spec[i].Priority); 
+		if(Spec[i].Period == 0) Bench_Sinks[Bench_SinkCnt++] = i; 
+	}
+	TIMER Tmr = NULL; 
+	if(Ret == 0 && IsrRate != 0){ 
+		Bench_IsrRate = IsrRate; 
+		Bench_IsrAcc = 0; 
+		Tmr = Tmr_New(Bench_Tick, NULL); 
+		if(Tmr == NULL) Ret = -1; 
+	}
+	u32 CtxSw = Lin_DebugCtxSwTimes; 
+	u32 Passes = Sched_DebugSchedTimes; 
+	int Kern = 0, Secs = 0; 
+	if(Ret == 0){ 
+		for(int i = 0; i < N; i++) OS_GenEvent(Bench_Tasks[i].Task, 0); 
+		if(Tmr != NULL) Tmr_Start(Tmr, 1, 1); 
+		u32 Start = TickCount; 
+		u32 Mark = Start; 
+		for(;;){ 	// Sample the scheduler share once a second. Steps run to fixed stamps, a Generic Event only splits one. 
+			u32 Gone = TickCount - Start; 
+			if(Gone >= Duration) break; 
+			if(TickCount - Mark >= 1000){ 
+				Kern += Load_Band(Load_BandKern); 
+				Secs++; 
+				Mark += 1000; 
+				continue; 
+			}
+			u32 Step = Mark + 1000 - TickCount; 
+			if(Step > Duration - Gone) Step = Duration - Gone; 
+			OS_WaitAny(NULL, 0, Step); 
+		}
+		CtxSw = Lin_DebugCtxSwTimes - CtxSw; 
+		Passes = Sched_DebugSchedTimes - Passes; 
+	}
+	if(Tmr != NULL) Tmr_Del(Tmr); 
+	for(int i = 0; i < Bench_TaskCnt; i++) OS_Del(Bench_Tasks[i].Task); 
+	Bench_SinkCnt = 0; 
+	OS_ChgPri(Self, Pri); 
+	if(Ret != 0) return Ret; 
+	u32 Util = 0; 
+	for(int i = 0; i < N; i++) if(Spec[i].Period != 0) Util += Spec[i].Wcet * 1000 / Spec[i].Period; 
+	Rep->Util = Util; 
+	Rep->Policy = -1; 
+	Rep->Releases = Bench_Releases; 
+	Rep->Misses = Bench_Misses; 
+	Rep->Max = Bench_Max; 
+	Rep->CtxSw = CtxSw; 
+	Rep->Passes = Passes; 
+	Rep->SchedPm = Secs ? Kern / Secs : Load_Band(Load_BandKern); 
+	u32 * Pct[3] = {&Rep->P50, &Rep->P90, &Rep->P99}; 
+	u32 Want[3] = {50, 90, 99}; 
+	for(int k = 0; k < 3; k++) *Pct[k] = Sched_Pct(Bench_Hist, Bench_Buckets, Want[k]); 	// Upper bound of the bucket holding the percentile, 0 without releases. 
+	return 0; 
+}
+
+SEQ Bench_SeqObj; 
+u32 Bench_SeqPub; 
+
+static void Bench_SeqTick(void * Arg){ 	// Writer of the contended run. 
+	u32 * Data = (u32 *)Arg; 
+	Data[0]++; 
+	Seq_Write(Bench_SeqObj, Data); 
+	Bench_SeqPub++; 
+}
+
+int Bench_Seq(u32 Size, u32 Duration, Bench_SeqReport * Rep){ 	// Returns 0, or -1 if it could not be set up. 
+	static u32 Shared[Bench_SeqMax / 4]; 	// The critical region variant. 
+	u32 Data[Bench_SeqMax / 4]; 
+	u32 Copy[Bench_SeqMax / 4]; 
+	Size = (Size + 3) & ~3; 
+	if(Size == 0 || Size > Bench_SeqMax) return -1; 
+	SEQ Seq = Seq_Create(Size); 
+	if(Seq == NULL) return -1; 
+	for(u32 i = 0; i < Size / 4; i++) Data[i] = i; 
+	Seq_Write(Seq, Data); 
+	u32 Empty = Lin_CycCnt(); 	// Cost of the timing itself. 
+	Empty = Lin_CycCnt() - Empty; 
+	u32 Sum[4] = {0, 0, 0, 0}; 
+	u32 Mask = 0; 
+	for(int n = 0; n < Bench_SeqIter; n++){ 
+		u32 t = Lin_CycCnt(); 
+		Seq_Read(Seq, Copy); 
+		Sum[0] += Lin_CycCnt() - t - Empty; 
+		t = Lin_CycCnt(); 
+		__critical_enter(); 
+		u32 m = Lin_CycCnt(); 
+		for(u32 i = 0; i < Size / 4; i++) Copy[i] = Shared[i]; 
+		m = Lin_CycCnt() - m; 
+		__critical_exit(); 
+		Sum[1] += Lin_CycCnt() - t - Empty; 
+		if(m > Mask) Mask = m; 
+		t = Lin_CycCnt(); 
+		Seq_Write(Seq, Data); 
+		Sum[2] += Lin_CycCnt() - t - Empty; 
+		t = Lin_CycCnt(); 
+		__critical_reenter(); 
+		for(u32 i = 0; i < Size / 4; i++) Shared[i] = Data[i]; 
+		__critical_exit(); 
+		Sum[3] += Lin_CycCnt() - t - Empty; 
+	}
+	Rep->Size = Size; 
+	Rep->ReadSeq = Sum[0] / Bench_SeqIter; 
+	Rep->ReadCrit = Sum[1] / Bench_SeqIter; 
+	Rep->WriteSeq = Sum[2] / Bench_SeqIter; 
+	Rep->WriteCrit = Sum[3] / Bench_SeqIter; 
+	Rep->MaskCrit = Mask; 
+	Rep->Reads = 0; 
+	Rep->Retries = 0; 
+	Rep->Publishes = 0; 
+	Bench_SeqObj = Seq; 
+	Bench_SeqPub = 0; 
+	TIMER Tmr = Tmr_New(Bench_SeqTick, Data); 
+	if(Tmr == NULL){ 
+		Seq_Destroy(Seq); 
+		return -1; 
+	}
+	Seq->Retries = 0; 
+	Tmr_Start(Tmr, 1, 1); 
+	u32 Start = TickCount; 
+	u32 Reads = 0; 
+	while(TickCount - Start < Duration){ 	// Busy reading, the timer task preempts us to publish. 
+		Seq_Read(Seq, Copy); 
+		Reads++; 
+	}
+	Tmr_Del(Tmr); 
+	Rep->Reads = Reads; 
+	Rep->Retries = Seq->Retries; 
+	Rep->Publishes = Bench_SeqPub; 
+	Seq_Destroy(Seq); 
+	return 0; 
+}
+
+int Bench_Msg(u32 Burst, Bench_MsgReport * Rep){ 	// Returns 0, or -1 for a busy mailbox or a failed send. 
+	static MSG Buf[Bench_MsgMax]; 
+	TASK Self = Lin_GetCurrTask(); 
+	if(Burst == 0 || Burst > Bench_MsgMax || OS_RxCnt() != 0) return -1; 
+	for(u32 i = 0; i < Burst; i++){ 
+		Buf[i].Src = 0; 
+		Buf[i].Cmd = Bench_Cmd; 
+		Buf[i].Pld = (void *)i; 
+	}
+	u32 Sum[4] = {0, 0, 0, 0}; 
+	int Ret = 0; 
+	for(int n = 0; n < Bench_MsgIter && Ret == 0; n++){ 
+		u32 t = Lin_CycCnt(); 
+		for(u32 i = 0; i < Burst && Ret == 0; i++) Ret = OS_TxMsg(Self, Buf[i]); 
+		Sum[0] += Lin_CycCnt() - t; 
+		if(Ret != 0) break; 
+		t = Lin_CycCnt(); 
+		for(u32 i = 0; i < Burst; i++) OS_RxMsg(); 
+		Sum[1] += Lin_CycCnt() - t; 
+		t = Lin_CycCnt(); 
+		Ret = OS_TxMsgN(Self, Buf, Burst); 
+		Sum[2] += Lin_CycCnt() - t; 
+		t = Lin_CycCnt(); 
+		OS_RxMsgN(Buf, Burst); 
+		Sum[3] += Lin_CycCnt() - t; 
+	}
+	while(OS_RxCnt() != 0) OS_RxMsg(); 	// Leftovers of a failed send. 
+	if(Ret != 0) return -1; 
+	Rep->Burst = Burst; 
+	Rep->SendOne = Sum[0] / (Bench_MsgIter * Burst); 
+	Rep->RecvOne = Sum[1] / (Bench_MsgIter * Burst); 
+	Rep->SendN = Sum[2] / (Bench_MsgIter * Burst); 
+	Rep->RecvN = Sum[3] / (Bench_MsgIter * Burst); 
+	return 0; 
+}
+
+static void Bench_Nop(TASK Self){ 	// Never released by Bench_Spawn. 
+	for(;;) OS_Suspend(); 
+}
+
+static u32 Bench_Binned(void){ 	// Blocks held by all recycle bins. 
+	u32 N = 0; 
+	for(int i = 0; i < Lin_RecyBins; i++) N += Lin_RecyCnt[i]; 
+	return N; 
+}
+
+int Bench_Spawn(u32 StkSize, Bench_SpawnReport * Rep){ 	// Returns 0, or -1 when out of memory. 
+	TASK Task[Bench_SpawnBatch]; 
+	u32 Sum[4] = {0, 0, 0, 0}; 
+	u32 Cnt[4] = {0, 0, 0, 0}; 
+	int Ret = 0; 
+	for(int n = 0; n < Bench_SpawnIter && Ret == 0; n++){ 
+		int k = 0; 
+		for(; k < Bench_SpawnBatch; k++){ 
+			u32 Bins = Bench_Binned(); 
+			u32 t = Lin_CycCnt(); 
+			Task[k] = OS_New(StkSize, Bench_Nop); 
+			t = Lin_CycCnt() - t; 
+			if(Task[k] == NULL){ 
+				Ret = -1; 
+				break; 
+			}
+			int Way = (Bench_Binned() < Bins) ? 1 : 0; 
+			Sum[Way] += t; 
+			Cnt[Way]++; 
+		}
+		while(k-- > 0){ 
+			u32 Bins = Bench_Binned(); 
+			u32 t = Lin_CycCnt(); 
+			OS_Del(Task[k]); 
+			t = Lin_CycCnt() - t; 
+			int Way = (Bench_Binned() > Bins) ? 3 : 2; 
+			Sum[Way] += t; 
+			Cnt[Way]++; 
+		}
+	}
+	Rep->StkSize = StkSize; 
+	Rep->NewFresh = Cnt[0] ? Sum[0] / Cnt[0] : 0; 
+	Rep->NewRecy = Cnt[1] ? Sum[1] / Cnt[1] : 0; 
+	Rep->DelFree = Cnt[2] ? Sum[2] / Cnt[2] : 0; 
+	Rep->DelRecy = Cnt[3] ? Sum[3] / Cnt[3] : 0; 
+	Rep->Fresh = Cnt[0]; 
+	Rep->Recy = Cnt[1]; 
+	Rep->Freed = Cnt[2]; 
+	Rep->Kept = Cnt[3]; 
+	return Ret; 
+}
+
+u32 Bench_Sweep(int N, u32 Duration, Bench_Report * Rep, u32 Seed){ 	// Every policy at 50, 70 and 90 percent utilization, 
+	// plus one sporadic task fed by the first task and 100 interrupts per second. 
+	// Rep takes Bench_Pols * 3 reports. Returns the total of deadline misses, saturated, 
+	// or Bench_Fail if a run could not be set up. Its report then holds Bench_Fail misses. 
+	static const u32 Utils[3] = {500, 700, 900}; 
+	Bench_Spec Spec[Bench_TaskMax]; 
+	u32 Misses = 0; 
+	int Failed = 0; 
+	if(N > Bench_TaskMax - 1) N = Bench_TaskMax - 1; 
+	for(int Pol = 0; Pol < Bench_Pols; Pol++){ 
+		for(int u = 0; u < 3; u++){ 
+			Bench_Report * R = &Rep[Pol * 3 + u]; 
+			Bench_Gen(Spec, N, Utils[u], Pol, Seed); 
+			Spec[0].FanOut = 1; 
+			Spec[N].Period = 0; 
+			Spec[N].Wcet = 50; 
+			Spec[N].Deadline = 1000; 
+			Spec[N].Priority = -1; 
+			Spec[N].FanOut = 0; 
+			if(Bench_Run(Spec, N + 1, 100, Duration, R) != 0){ 
+				Bench_Report Empty = {0}; 
+				*R = Empty; 
+				R->Misses = Bench_Fail; 
+				Failed = 1; 
+			}
+			R->Util = Utils[u]; 
+			R->Policy = Pol; 
+			if(R->Misses == Bench_Fail) continue; 
+			Misses += R->Misses; 
+			if(Misses < R->Misses || Misses == Bench_Fail) Misses = Bench_Fail - 1; 	// Saturate below the failure mark. 
+		}
+	}
+	return Failed ? Bench_Fail : Misses; 
+}
+
+int Bench_Check(const Bench_Report * Rep, const Bench_Report * Base, int N){ 	// Reports worse than their baselines. Returns how many. 
+	int Bad = 0; 
+	for(int i = 0; i < N; i++){ 
+		const Bench_Report * R = &Rep[i]; 
+		const Bench_Report * B = &Base[i]; 
+		if(R->Misses == Bench_Fail) Bad++; 
+		else if(B->Misses == Bench_Fail) continue; 	// A failed baseline has no figures to hold a run to. 
+		else if(R->Misses > B->Misses + Bench_TolMiss) Bad++; 
+		else if(R->P99 > (B->P99 << Bench_TolBkt)) Bad++; 
+		else if(R->SchedPm > B->SchedPm + Bench_TolPm) Bad++; 
+	}
+	return Bad; 
+}
+
+static void Bench_Put(const char * Str){ 
+#if Bench_Semi 
+	__semihost(0x04, Str); 	// SYS_WRITE0 to the debug console. 
+#endif 
+}
+
+static void Bench_PutInt(int Value, int Last){ 
+	char Buf[16]; 
+	int n = sizeof(Buf) - 1; 
+	u32 V = (Value < 0) ? -(u32)Value : (u32)Value; 
+	Buf[n] = 0; 
+	if(!Last){ 
+		Buf[--n] = ' '; 
+		Buf[--n] = ','; 
+	}
+	do Buf[--n] = '0' + V % 10; while((V /= 10) != 0); 
+	if(Value < 0) Buf[--n] = '-'; 
+	Bench_Put(Buf + n); 
+}
+
+int Bench_Regress(int N, u32 Duration, u32 Seed, const Bench_Report * Base, Bench_Report * Rep){ 	// Sweep and compare with a baseline. 
+	// Rep takes Bench_Pols * 3 reports. Returns the number of regressions, 0 for a pass. 
+	// Without Base the sweep is only printed, to be stored as the baseline. 
+	Bench_Sweep(N, Duration, Rep, Seed); 
+	int Bad = 0; 
+	Bench_Put("static const Bench_Report Base[] = {\n"); 
+	for(int i = 0; i < Bench_Pols * 3; i++){ 
+		const Bench_Report * R = &Rep[i]; 
+		int Worse = (Base != NULL) ? Bench_Check(R, &Base[i], 1) : 0; 
+		Bad += Worse; 
+		Bench_Put("\t{"); 
+		Bench_PutInt(R->Util, 0); 
+		Bench_PutInt(R->Policy, 0); 
+		Bench_PutInt(R->Releases, 0); 
+		if(R->Misses == Bench_Fail) Bench_Put("Bench_Fail, "); 
+		else Bench_PutInt(R->Misses, 0); 
+		Bench_PutInt(R->P50, 0); 
+		Bench_PutInt(R->P90, 0); 
+		Bench_PutInt(R->P99, 0); 
+		Bench_PutInt(R->Max, 0); 
+		Bench_PutInt(R->CtxSw, 0); 
+		Bench_PutInt(R->Passes, 0); 
+		Bench_PutInt(R->SchedPm, 1); 
+		Bench_Put(Worse ? "}, \t// Regressed\n" : "}, \n"); 
+	}
+	Bench_Put("};\n"); 
+	if(Base != NULL) Bench_Put(Bad ? "FAIL\n" : "PASS\n"); 
+#if Bench_Semi 
+	if(Base != NULL){ 	// SYS_EXIT_EXTENDED, QEMU exits with Bad as its status. 
+		u32 Exit[2] = {0x20026, (u32)Bad}; 
+		__semihost(0x20, Exit); 
+	}
+#endif 
+	return Bad; 
+}
+
+// End of file. 
@@ -0,0 +1,105 @@
+// Synthetic Workload Benchmark version 0.5.1 header file 
+#ifndef __Bench_H__ 
+#define __Bench_H__ 
+
+// Configuration 
+#define Bench_TaskMax 	16 		// Tasks in one set 
+#define Bench_Buckets 	24 		// Response time histogram, bucket n holds [2^(n-1), 2^n) us 
+#define Bench_StkSize 	512 
+#define Bench_RunPri 	-8 		// Priority of the task calling Bench_Run, above every benchmark task 
+#define Bench_SeqMax 	64 		// Largest snapshot for Bench_Seq, Bytes 
+#define Bench_SeqIter 	256 	// Timed operations per figure in Bench_Seq 
+#define Bench_MsgMax 	32 		// Largest burst for Bench_Msg 
+#define Bench_MsgIter 	64 		// Bursts timed per figure in Bench_Msg 
+#define Bench_SpawnBatch 8 		// Tasks alive at once in Bench_Spawn 
+#define Bench_SpawnIter 	32 		// Batches in Bench_Spawn 
+#define Bench_Fail 		0xFFFFFFFF 	// Misses of a run that could not be set up, and what Bench_Sweep returns then 
+
+// Regression Tolerances of Bench_Check against a baseline 
+#define Bench_TolMiss 	2 		// Extra deadline misses 
+#define Bench_TolBkt 	1 		// Histogram buckets P99 may move up 
+#define Bench_TolPm 	20 		// Permille the scheduler share may grow 
+#ifndef Bench_Semi 
+#define Bench_Semi 		0 		// 1: Bench_Regress prints over semihosting and ends a QEMU run with the verdict 
+#endif 
+
+// Priority Assignment Policies for Bench_Gen 
+#define Bench_PolRM 	0 	// Rate monotonic: shorter periods get higher priorities 
+#define Bench_PolFlat 	1 	// One priority for all, time slicing decides 
+#define Bench_PolRand 	2 	// Random priorities 
+#define Bench_Pols 		3 
+
+// Task Specification 
+typedef struct Bench_Spec{ 
+	u32 Period; 		// us, 0 for a sporadic task run by messages 
+	u32 Wcet; 			// us of work per release or message 
+	u32 Deadline; 		// us after the release, 0 for the period 
+	int Priority; 
+	int FanOut; 		// Messages sent to sporadic tasks per release 
+}Bench_Spec; 
+
+// Results of one run 
+typedef struct Bench_Report{ 
+	u32 Util; 			// Requested utilization, permille 
+	int Policy; 
+	u32 Releases; 		// Periodic releases and sporadic messages handled 
+	u32 Misses; 		// Deadlines missed, skipped releases included 
+	u32 P50; 			// Response time percentiles in us, upper bounds of their buckets 
+	u32 P90; 
+	u32 P99; 
+	u32 Max; 			// Worst response time in us 
+	u32 CtxSw; 			// Context switches 
+	u32 Passes; 		// Scheduling passes 
+	int SchedPm; 		// CPU share of the scheduler, permille 
+}Bench_Report; 
+
+// Published state against a critical region, see Bench_Seq. Cycles unless noted. 
+typedef struct Bench_SeqReport{ 
+	u32 Size; 			// Snapshot Bytes 
+	u32 ReadSeq; 		// Mean Seq_Read 
+	u32 ReadCrit; 		// Mean copy under __critical_enter 
+	u32 WriteSeq; 		// Mean Seq_Write 
+	u32 WriteCrit; 		// Mean copy in under __critical_enter 
+	u32 MaskCrit; 		// Longest interval with interrupts masked by a critical reader, Seq readers mask none 
+	u32 Reads; 			// Seq_Read calls during the contended run 
+	u32 Retries; 		// Of which had to start over 
+	u32 Publishes; 		// Seq_Write calls by the timer during the contended run 
+}Bench_SeqReport; 
+
+// Messaging throughput, see Bench_Msg. Cycles per Message. 
+typedef struct Bench_MsgReport{ 
+	u32 Burst; 			// Messages per burst 
+	u32 SendOne; 		// OS_TxMsg, one call per Message 
+	u32 RecvOne; 		// OS_RxMsg, one call per Message 
+	u32 SendN; 			// OS_TxMsgN, one call per burst 
+	u32 RecvN; 			// OS_RxMsgN, one call per burst 
+}Bench_MsgReport; 
+
+// Task spawn and delete latency, see Bench_Spawn. Mean cycles per call. 
+typedef struct Bench_SpawnReport{ 
+	u32 StkSize; 
+	u32 NewFresh; 		// OS_New served by the heap 
+	u32 NewRecy; 		// OS_New served by a recycle bin 
+	u32 DelFree; 		// OS_Del returning the block to the heap 
+	u32 DelRecy; 		// OS_Del keeping the block in a bin 
+	u32 Fresh; 			// Calls behind each figure, in the same order 
+	u32 Recy; 
+	u32 Freed; 
+	u32 Kept; 
+}Bench_SpawnReport; 
+
+u32  Bench_Rand(void); 
+void Bench_Burn(u32 Us); 
+int  Bench_Gen(Bench_Spec * Spec, int N, u32 Util, int Policy, u32 Seed); 
+int  Bench_Run(const Bench_Spec * Spec, int N, u32 IsrRate, u32 Duration, Bench_Report * Rep); 
+u32  Bench_Sweep(int N, u32 Duration, Bench_Report * Rep, u32 Seed); 
+int  Bench_Check(const Bench_Report * Rep, const Bench_Report * Base, int N); 
+int  Bench_Regress(int N, u32 Duration, u32 Seed, const Bench_Report * Base, Bench_Report * Rep); 
+void Bench_Isr(void); 
+int  Bench_Seq(u32 Size, u32 Duration, Bench_SeqReport * Rep); 
+int  Bench_Msg(u32 Burst, Bench_MsgReport * Rep); 
+int  Bench_Spawn(u32 StkSize, Bench_SpawnReport * Rep); 
+
+#endif 
+
+// End of file. 
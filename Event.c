@@ -1,19 +1,159 @@
-// Dummy Event System 
-int Event_DebugEventQurtyCnt; 
-int Event_DebugEvCycleStamp; 
-
-void Ev_Init(void){ 
-	Event_DebugEvCycleStamp = 0; 
-	Event_DebugEventQurtyCnt = 0; 
-}
-
-int Ev_Query(void * EvRef){ 
-	Event_DebugEventQurtyCnt++; 
-	return 0; 
-}
-
-void Ev_Cycle(void){ 
-	Event_DebugEvCycleStamp++; 
-}
-
-// End of file. 
+// Event System version 1.1.3 
+/* Release Notes: 
+
+		<1.1.3 > 261019 Added Ev_Epoch and Ev_BcstSince for waiters that latch the epoch they were armed in. 
+		<1.1.2 > 261019 Debug counters updated through Met_Inc, the query count no longer outside a critical region. 
+		<1.1.1 > 261019 Signals request a scheduling pass, see Sched_TickCheck. 
+		<1.1.0 > 261019 Cycle-coherent broadcasts using Ev_Cycle epochs. 
+		<1.0.0 > 261019 Real event objects: counting semaphores, event flag groups and message queue readiness. 
+		<0.1.0 >        Dummy Event System. 
+*/
+#include <Lin.h> 
+#include <Sched.h> 
+#include "Event.h" 
+
+/* Broadcasts: 
+	Ev_Cycle is called once per scheduling pass, after both symmetric phases, 
+	and starts a new epoch. A broadcast signalled at any time during epoch N 
+	is latched when epoch N+1 starts and is visible to every waiter checked in it, 
+	i.e. every task of the next pass. Epoch N+2 retires it with no work at all. 
+	Each waiter is checked once per pass, so it sees the broadcast exactly once. 
+	Only tasks already waiting are released, nothing is remembered for later waiters. 
+*/
+int Event_DebugEventQurtyCnt; 
+int Event_DebugEvCycleStamp; 
+u32 Event_Epoch; 					// Current epoch, advanced by Ev_Cycle 
+Ev_Bcst * Event_BcstArmed; 	// Broadcasts signalled in this epoch 
+
+void Ev_Init(void){ 
+	Event_DebugEvCycleStamp = 0; 
+	Event_DebugEventQurtyCnt = 0; 
+	Event_Epoch = 0; 
+	Event_BcstArmed = NULL; 
+}
+
+int Ev_Query(void * EvRef){ 	// Called by the scheduler for each Event Reference. Consumes the event if it fired. 
+	Met_Inc(Event_DebugEventQurtyCnt); 
+	if(EvRef == NULL) return 0; 
+	int Fired = 0; 
+	__critical_enter(); 
+	switch(*(int *)EvRef){ 
+		case Ev_TypeSem:{ 
+			Ev_Sem * Sem = (Ev_Sem *)EvRef; 
+			if(Sem->Count > 0){ 
+				Sem->Count--; 
+				Fired = 1; 
+			}
+			break; 
+		}
+		case Ev_TypeFlg:{ 
+			Ev_Flg * Flg = (Ev_Flg *)EvRef; 
+			u32 Got = Flg->Grp->Flags & Flg->Mask; 
+			if(Flg->Mode & Ev_FlgAll) Fired = (Got == Flg->Mask); 
+			else Fired = (Got != 0); 
+			if(Fired){ 
+				Flg->Got = Got; 
+				if(Flg->Mode & Ev_FlgClr) Flg->Grp->Flags &= ~Got; 
+			}
+			break; 
+		}
+		case Ev_TypeMsgQ:{ 
+			Ev_MsgQ * MsgQ = (Ev_MsgQ *)EvRef; 
+			Fired = (MsgQ->Task->MsgQty >= MsgQ->Level); 
+			break; 
+		}
+		case Ev_TypeBcst:{ 
+			Fired = (((Ev_Bcst *)EvRef)->Epoch == Event_Epoch); 
+			break; 
+		}
+	}
+	__critical_exit(); 
+	return Fired; 
+}
+
+void Ev_Cycle(void){ 	// Start a new epoch and latch the broadcasts signalled in the last one. 
+	__critical_enter(); 
+	Met_Inc(Event_DebugEvCycleStamp); 
+	u32 Epoch = ++Event_Epoch; 
+	Ev_Bcst * Bcst = Event_BcstArmed; 
+	while(Bcst != NULL){ 
+		Bcst->Epoch = Epoch; 
+		Bcst->Armed = 0; 
+		Bcst = Bcst->Next; 
+	}
+	if(Event_BcstArmed != NULL) Sched_Wake(); 	// Waiters see it in the next pass. 
+	Event_BcstArmed = NULL; 
+	__critical_exit(); 
+}
+
+// Counting Semaphore 
+void Ev_SemInit(Ev_Sem * Sem, int Count, int Max){ 	// Max <= 0 for no limit. 
+	Sem->Type = Ev_TypeSem; 
+	Sem->Count = Count; 
+	Sem->Max = Max; 
+}
+
+void Ev_SemPost(Ev_Sem * Sem){ 	// ISR safe. 
+	__critical_enter(); 
+	if(Sem->Max <= 0 || Sem->Count < Sem->Max) Sem->Count++; 
+	Sched_Wake(); 
+	__critical_exit(); 
+}
+
+int Ev_SemTake(Ev_Sem * Sem){ 	// Non-blocking. Returns 1 if a count was taken. 
+	return Ev_Query(Sem); 
+}
+
+// Event Flag Group 
+void Ev_GrpInit(Ev_Grp * Grp){ 
+	Grp->Flags = 0; 
+}
+
+void Ev_GrpSet(Ev_Grp * Grp, u32 Flags){ 	// ISR safe. 
+	__critical_enter(); 
+	Grp->Flags |= Flags; 
+	Sched_Wake(); 
+	__critical_exit(); 
+}
+
+void Ev_GrpClr(Ev_Grp * Grp, u32 Flags){ 	// ISR safe. 
+	__critical_enter(); 
+	Grp->Flags &= ~Flags; 
+	__critical_exit(); 
+}
+
+void Ev_FlgInit(Ev_Flg * Flg, Ev_Grp * Grp, u32 Mask, int Mode){ 
+	Flg->Type = Ev_TypeFlg; 
+	Flg->Grp = Grp; 
+	Flg->Mask = Mask; 
+	Flg->Mode = Mode; 
+	Flg->Got = 0; 
+}
+
+// Message Queue readiness 
+void Ev_MsgQInit(Ev_MsgQ * MsgQ, TASK Task, int Level){ 	// Task NULL for the current one. 
+	MsgQ->Type = Ev_TypeMsgQ; 
+	MsgQ->Task = (Task != NULL) ? Task : Lin_GetCurrTask(); 
+	MsgQ->Level = (Level > 0) ? Level : 1; 
+}
+
+// Broadcast 
+void Ev_BcstInit(Ev_Bcst * Bcst){ 
+	Bcst->Type = Ev_TypeBcst; 
+	Bcst->Epoch = Event_Epoch - 1; 
+	Bcst->Armed = 0; 
+	Bcst->Next = NULL; 
+}
+
+void Ev_BcstSignal(Ev_Bcst * Bcst){ 	// ISR safe. Signals within one epoch coalesce. 
+	__critical_enter(); 
+	if(Bcst->Armed == 0){ 
+		Bcst->Armed = 1; 
+		Bcst->Next = Event_BcstArmed; 
+		Event_BcstArmed = Bcst; 
+	}
+	Sched_Wake(); 
+	__critical_exit(); 
+}
+
+// End of file. 
@@ -1,9 +1,80 @@
-// Dummy Event System header file 
-#ifndef __Event_H__ 
-#define __Event_H__ 
-
-void Ev_Init(void); 
-int  Ev_Query(void * EvRef); 
-void Ev_Cycle(void); 
-
-#endif 
+// Event System version 1.1.3 header file 
+#ifndef __Event_H__ 
+#define __Event_H__ 
+
+/* Comments: 
+	Event References in the ECB Event List point at one of the objects below. 
+	Ev_Query identifies them by their leading Type field. 
+	A query that finds the event fired also consumes it on behalf of the woken task, 
+	so a semaphore count or a cleared flag wakes exactly one waiter. 
+	Broadcasts are the exception: they are never consumed but live for one Ev_Cycle epoch, 
+	see Event.c. 
+*/
+
+#define Ev_TypeSem 	1 	// Counting Semaphore 
+#define Ev_TypeFlg 	2 	// Event Flag wait descriptor 
+#define Ev_TypeMsgQ 3 	// Message Queue readiness 
+#define Ev_TypeBcst 4 	// Broadcast 
+
+#define Ev_FlgAny 	0 	// Fire on any bit of the mask 
+#define Ev_FlgAll 	1 	// Fire on all bits of the mask 
+#define Ev_FlgClr 	2 	// Or'ed: consume the matched bits on wake 
+
+// Counting Semaphore 
+typedef struct Ev_Sem{ 
+	int Type; 
+	int Count; 
+	int Max; 
+}Ev_Sem; 
+
+// 32-bit Event Flag Group, not an Event Reference itself 
+typedef struct Ev_Grp{ 
+	u32 Flags; 
+}Ev_Grp; 
+
+// Event Flag wait descriptor, one per waiter 
+typedef struct Ev_Flg{ 
+	int Type; 
+	Ev_Grp * Grp; 
+	u32 Mask; 
+	int Mode; 
+	u32 Got; 	// Flags seen when fired 
+}Ev_Flg; 
+
+// Message Queue readiness, fires while Task holds at least Level messages 
+typedef struct Ev_MsgQ{ 
+	int Type; 
+	TASK Task; 
+	int Level; 
+}Ev_MsgQ; 
+
+// Broadcast, releases every task waiting on it for one epoch 
+typedef struct Ev_Bcst{ 
+	int Type; 
+	u32 Epoch; 						// Epoch in which it is visible 
+	int Armed; 						// Signalled, to be latched at the next Ev_Cycle 
+	struct Ev_Bcst * Next; 	// In the armed list 
+}Ev_Bcst; 
+
+void Ev_Init(void); 
+int  Ev_Query(void * EvRef); 
+void Ev_Cycle(void); 
+
+void Ev_SemInit(Ev_Sem * Sem, int Count, int Max); 
+void Ev_SemPost(Ev_Sem * Sem); 
+int  Ev_SemTake(Ev_Sem * Sem); 
+
+void Ev_GrpInit(Ev_Grp * Grp); 
+void Ev_GrpSet(Ev_Grp * Grp, u32 Flags); 
+void Ev_GrpClr(Ev_Grp * Grp, u32 Flags); 
+void Ev_FlgInit(Ev_Flg * Flg, Ev_Grp * Grp, u32 Mask, int Mode); 
+
+void Ev_MsgQInit(Ev_MsgQ * MsgQ, TASK Task, int Level); 
+
+extern u32 Event_Epoch; 
+#define Ev_Epoch() (Event_Epoch) 	// Current epoch, see Ev_Cycle 
+#define Ev_BcstSince(bcst, epoch) ((s32)((bcst)->Epoch - (epoch)) > 0) 	// Latched in a later epoch? 
+void Ev_BcstInit(Ev_Bcst * Bcst); 
+void Ev_BcstSignal(Ev_Bcst * Bcst); 
+
+#endif 
@@ -1,526 +1,949 @@
-// Lin Architecture version 4.0.1 for lyrinka OS 
-/* The Lin Architecture Framework. 
-	Major changes in stack data structures 
-	providing a smart and flexiable interface 
-	but incompatable with older versions. 
-	
-	The memory operation and messaging operation still uses micro lib, 
-	which may hit performance. 
-	Please enable micro lib and configure sufficent heap area in startup_stm32f10x_md.s 
-	
-	Release notes: 
-	
-	<4.0.1 > 190316 Header file now works in C++. Pending improvements on the flexarray at line 102. 
-	<4.0.0 > 190301 ThreadExit changed to ProcessExit. 
-					Minor modification on task prototype, easy access of Self pointer, now: 
-						void funcTask(TASK Self, int Arg0, int Arg1, u32 Cnt); 
-	<3.1.3 > 190206 Changed some debug info to unsigned. 
-	<3.1.2 > 190127 Changed TCB Data Structure for Event Managements. 
-									Added Event Control Block Data Structure. 
-									DataStructure optimized for Operating System using Lin. 
-									Updated StkInit for new data structures. New Tasks are created Dead (i.e. NULLS on all surrounding pointers) 
-									Initializations of chained lists are included for Lint is an addon of Lin. 
-									But OS related control information is not initialized. These are thrown directly to the operating system. 
-	<3.1.1 > 181225 Added support in data structure for priority queue and waiting list chained lists. 
-									Added macros for entering/exiting critical regions. 
-									Code not changed. 
-	<3.0.2 > 181115	Debugged and fully commented. 
-	<3.0.1 > 181113	Using Message Pool & Carrier design 
-									Using Single-chained Lists for Message Carriers. 
-	<3.0.0 > 181112	Copies of last version 2.1.2 
-*/ 
-
-#include <stm32f10x.h> 
-#include "Lin.h" 
-
-
-// using micro lib 
-void * 	malloc(u32 Size); 
-void 		free(void * Mem); 
-
-
-// Private variables & functions 
-TASK 					Lin_CurrTask; 		// Indicates the Current running Task reference 
-TASK 					Lin_NextTask; 		// Indicates the Next Task to be run referrence 
-TASK 					Lin_MainTask; 		// Indicates the Main Task reference 
-void * 				Lin_TaskLoader; 	// Storage for MSP on loading of the first task 
-
-int Lin_DebugMemLeak; 					// Shows any allocations without deallocation 
-u32 Lin_DebugMemAllocTimes; 		// Total times of memory allocations 
-u32 Lin_DebugMsgOpTimes; 				// Total times of message queue operations 
-u32 Lin_DebugCtxSwTimes; 				// Total times of context switching 
-
-void 					Lin_InitMem		(u8 * MemS, u8 * MemE); 						// Initializes memory framework 
-void 					Lin_InitSw		(void); 														// Initializes context switching framework 
-void 					Lin_InitMsg		(u32 PoolSize); 										// Initializes message carrier pool framework 
-TASK 					Lin_StkInit		(u8 * Mem, u32 Size, void * Func); 	// Initialization of a new Task 
-int 					Lin_Call			(TASK Task); 												// Request for first context switch from MSP 
-Lin_MsgBlk * 	Lin_MsgPoolGet(void); 														// Get carrier block from message pool 
-void 					Lin_MsgPoolRet(Lin_MsgBlk * MsgBlk); 							// Return carrier block from message pool 
-void 					Lin_MsgEnQ		(TASK Task, Lin_MsgBlk * MsgBlk); 	// Enqueue message carrier 
-void 					Lin_MsgEnQF		(TASK Task, Lin_MsgBlk * MsgBlk); 	// Enqueue message carrier, but at the front 
-Lin_MsgBlk * 	Lin_MsgDeQ		(TASK Task); 												// Dequeue message carrier 
-
-// Exception Handlers 
-void 												PendSV_Handler(void); 	// Pending Service Handler 
-void 												SVC_Handler		(void); 	// System Service Call Handler 
-
-// Macros 
-#define Lin_CritEnter() u32 __Lin_IE = __get_PRIMASK(); __disable_irq() 	// Enter critical region 
-#define Lin_CritExit() __set_PRIMASK(__Lin_IE) 														// Exit critical region 
-
-// External Functions 
-extern void SVC_ProxyCaller(u8 ID, u32 * StkF); 	// Other SVC Calls redirected to here. weakly defined. 
-
-
-// Function Definitions. 
-// ************************************************************************************ 
-// System Startup: 
-// Initialize the whole system including: 
-/*	Memory Management 
-		Task Management 
-		Interrupts & Context Switching 
-		Inter-Task Messaging 
-*/
-void Lin_Init(void){ 
-	Lin_InitMem((u8 *)Lin_MemStart, (u8 *)Lin_MemEnd); 
-	Lin_InitSw(); 
-	Lin_InitMsg(Lin_MsgPoolSize); 
-}
-// End of a section. 
-
-
-// ************************************************************************************ 
-// Memory Managements: 
-// Allocate a chunk of memory: 
-/*	If failed the function return a NULL pointer. 
-		Sizes are in Bytes. 
-		Returned pointer is Word-Aligned. 
-*/
-void * Lin_MemAlloc(u32 Size){ 
-	Lin_CritEnter(); 
-	Lin_DebugMemLeak++; 
-	Lin_DebugMemAllocTimes++; 
-	void * Mem = malloc(Size); 
-	Lin_CritExit(); 
-	return Mem; 
-}
-// Free up a chunk of memory: 
-/*	If input pointer is not valid 
-		the function ignore the freeing operation. 
-*/
-void Lin_MemFree(void * Mem){ 
-	Lin_CritEnter(); 
-	Lin_DebugMemLeak--; 
-	free(Mem); 
-	Lin_CritExit(); 
-}
-// End of a section. 
-
-
-// ************************************************************************************ 
-// Task Management: 
-// Create ane Initialize a new Task: 
-/*	This function allocates memory. 
-		StkSize in Bytes. 
-		PC could be any function pointer but 
-		the best would be 
-		void Task(int Arg0, int Arg1, u32 Counter, TASK * Self); 
-*/
-TASK Lin_New(u32 StkSize, void * PC){ 
-	void * Mem = Lin_MemAlloc(StkSize); 
-	if(Mem == NULL) return (TASK)NULL; 
-	return Lin_StkInit(Mem, StkSize, PC); 
-}
-// Set the arguments of a Task. 
-/*	These values are read only on the 
-		re-entering of a task. 
-*/
-void Lin_SetArgs(TASK Task, int Arg0, int Arg1){ 
-	Task->Arg0 = Arg0; 
-	Task->Arg1 = Arg1; 
-}
-// Set the entrance point of a Task. 
-/*	The entrance point is not active till the
-		re-entering of a task. 
-*/
-void Lin_SetPC(TASK Task, void * PC){ 
-	Task->PC = PC; 
-}
-// Enter a Task from normal program. 
-/*	The normal C program uses MSP. 
-		The Task Framework uses separate PSPs for each Task. 
-		The Task being entered first becomes the MainTask, 
-		providing easy access from anywhere within the framework. 
-		Like Standard C Call, 
-		The task framework may return an int value. 
-*/
-int Lin_Enter(TASK Task){ 
-	Lin_MainTask = Task; 
-	return Lin_Call(Task); 
-}
-// Return to normal program from any Task. 
-/*	Like Standard C Call, 
-		The task framework may return an int value. 
-		It is the normal program's responsibility 
-		to release all Task Stack Memories. 
-*/
-__asm void Lin_Return(int retval){ 
-		SVC		SVCn_LinTrigger 
-		BX		LR 
-}
-// Delete a task by releasing all its memory. 
-/*	This function does not really disabling the task. 
-		It just releases all the associated memory, 
-		including StackMemory and all Message Blocks(Carriers). 
-		Re-entering this task may cause serious violations 
-		for the stack and the TCB structure may be corrupted 
-		by other allocations of the memory. 
-*/
-void Lin_Delete(TASK Task){ 
-	Lin_CritEnter(); 
-	while(Task->MsgQty) Lin_MsgGet(Task); 
-	Lin_MemFree(Task->ECB); 
-	Lin_CritExit(); 
-}
-// End of a section. 
-
-
-// ************************************************************************************ 
-// Context Switching: 
-// Switching inbetween Task. 
-__asm void Lin_Switch(TASK Task){ 
-		SVC		SVCn_LinSwitch 
-		BX		LR 
-}
-// Switching inbetween Task from ISR. 
-void Lin_SwitchISR(TASK Task); 
-/*	This function stays in the 
-//	void SVC_Handler(void); 
-//	for the optimization of speed. 
-*/
-// Switching to the MainTask. 
-void Lin_Yield(void){ 
-	Lin_Switch(Lin_MainTask); 
-}
-// Switching to the MainTask from ISR. 
-void Lin_YieldISR(void){ 
-	Lin_SwitchISR(Lin_MainTask); 
-}
-// End of a section. 
-
-
-// ************************************************************************************ 
-// Miscellaneous: 
-// Get Current Executing Task. 
-/*	Still applicable from ISR, 
-		Indicating the interrupted Task. 
-*/
-TASK Lin_GetCurrTask(void){ 
-	return Lin_CurrTask; 
-}
-// Get MainTask. 
-TASK Lin_GetMainTask(void){ 
-	return Lin_MainTask; 
-}
-// End of a section. 
-
-
-// ************************************************************************************ 
-// Inter-Task Messaging: 
-// Enqueue Message to a Task. 
-/*	If there is not enough memory for getting the Carrier Block, 
-		The function returns -1, 
-		Else it returns 0. 
-		Same for all other functions indicated below. 
-*/
-int Lin_MsgPut(TASK Task, MSG Msg){ 
-	Lin_MsgBlk * MsgBlk = Lin_MsgPoolGet(); 
-	if(MsgBlk == NULL) return -1; 
-	MsgBlk->Msg = Msg; 
-	Lin_MsgEnQ(Task, MsgBlk); 
-	return 0; 
-}
-// Enqueue Message to a Task, but at opposite front. 
-/*	Note: Same as MsgPut. 
-*/
-int Lin_MsgPutF(TASK Task, MSG Msg){ 
-	Lin_MsgBlk * MsgBlk = Lin_MsgPoolGet(); 
-	if(MsgBlk == NULL) return -1; 
-	MsgBlk->Msg = Msg; 
-	Lin_MsgEnQF(Task, MsgBlk); 
-	return 0; 
-}
-// Enqueue Message to MainTask. 
-/*	Note: Same as MsgPut. 
-*/
-int Lin_MsgSubmit(MSG Msg){ 
-	return Lin_MsgPut(Lin_MainTask, Msg); 
-}
-// Enqueue Message to MainTask, but at opposite front. 
-/*	Note: Same as MsgPut. 
-*/
-int Lin_MsgSubmitF(MSG Msg){ 
-	return Lin_MsgPutF(Lin_MainTask, Msg); 
-}
-// Get number in the waiting queue of the Current Task. 
-/*	Still applicable from ISR, 
-		Indicating the queue status of the interrupted Task. 
-*/
-u32 Lin_MsgQty(void){ 
-		return Lin_CurrTask->MsgQty; 
-}
-// Dequeue Message from any Task, and releasing associated memory. 
-/*	If there is no message in the queue, 
-		the function returns an empty Message content. 
-		Always check queue status before dequeueing the message queue. 
-		Same for all other functions indicated below. 
-*/
-MSG Lin_MsgGet(TASK Task){ 
-	Lin_MsgBlk * MsgBlk = Lin_MsgDeQ(Task); 
-	MSG Msg; 
-	Msg.Src = 0; 
-	Msg.Cmd = 0; 
-	Msg.Pld = NULL; 
-	if(MsgBlk == NULL) return Msg; 
-	Msg = MsgBlk->Msg; 
-	Lin_MsgPoolRet(MsgBlk); 
-	return Msg; 
-}
-// Dequeue Message from Current Task, and releasing associated memory. 
-/*	Note: See MsgGet. 
-*/
-MSG	Lin_MsgRecv(void){ 
-	return Lin_MsgGet(Lin_CurrTask); 
-}
-// Preview Message in the Current Task queue. 
-/*	Previewing does not remove the carrier block from the queue. 
-		It just snaps the value into a variable then returns it. 
-		Note: See MsgGet. 
-*/
-MSG Lin_MsgPrvw(void){ 
-	Lin_CritEnter(); 
-	Lin_MsgBlk * MsgBlk = Lin_CurrTask->MsgHead; 
-	MSG Msg; 
-	Msg.Src = 0; 
-	Msg.Cmd = 0; 
-	Msg.Pld = NULL; 
-	if(MsgBlk != NULL) Msg = MsgBlk->Msg; 
-	Lin_CritExit(); 
-	return Msg; 
-}
-// End of a section. 
-
-
-// ************************************************************************************ 
-// Private Functions: 
-// Initialize the Memory Management framework. 
-// Currently dummy. 
-static void Lin_InitMem(u8 * MemS, u8 * MemE){ 
-	Lin_DebugMemLeak = 0; 
-	Lin_DebugMemAllocTimes = 0; 
-}
-// Initilize the Context Switching Environment. 
-// 1.0.6 Framework not changed. 
-static void Lin_InitSw(void){ 
-	// User Functions - NVIC and Handler Initialization 
-	SCB->CCR |= 1 << 9; 																	// Disable Stack DW Align 
-	SCB->AIRCR = (5 << 8) | (0x05FA << 16); 							// Priority Group 5, 2bits+2bits 
-	SCB->ICSR = 1 << 27; 																	// PendSV Pend Clear 
-	SCB->SHCSR &= ~(1 << 15); 														// SVC Pend Clear 
-	SCB->SHP[12+PendSV_IRQn] = (3 << 6) | (3 << 4) | 15; 	// PendSV Lowest Priority 
-	SCB->SHP[12+SVCall_IRQn] = (3 << 6) | (2 << 4); 			// SVC Pp same as PendSV, Sp higher than PendSV 
-	Lin_CurrTask = NULL; 
-	Lin_NextTask = NULL; 
-	Lin_MainTask = NULL; 
-	Lin_TaskLoader = NULL; 
-	Lin_DebugCtxSwTimes = 0; 
-}
-// Initilize the Messaging Framework. 
-// Currently dummy. 
-static void Lin_InitMsg(u32 PoolSize){ 
-	Lin_DebugMsgOpTimes = 0; 
-}
-// Initilize the Stack of a new Task. 
-// ProcessExit routine also included. 
-static __asm TASK Lin_StkInit(u8 * Memory, u32 Size, void * funcPtr){ 
-		ADD		R3,  R0, R1 		
-		SUB		R3,  #64 
-		STR		R0, [R3, #60] // SL 
-		MOV		R0,  #0 
-		STR		R0, [R3, #44] // RBN 
-		STR		R0, [R3, #40] // LBN 
-		STR		R0, [R3, #36] // Next 
-		STR		R0, [R3, #32] // Prev 
-		STR		R0, [R3, #28] // MsgTail 
-		STR		R0, [R3, #24] // MsgHead
-		STR		R0, [R3, #20] // MsgQty 
-		STR		R0, [R3, #12] // Arg1 
-		STR		R0, [R3, #08] // Arg0 
-		MVN		R0,  R0 
-		STR		R0, [R3, #16] // Cntr 
-		STR		R2, [R3, #04] // PC 
-		SUB		R0,  R3, #64 
-		STR		R0, [R3] // SP 
-		MOV		R0, #0x01000000 
-		STR		R0, [R3, #-4] // xPSR 
-		LDR		R0, =ProcessExit 
-		STR		R0, [R3, #-8] // ThreadExit 
-		MOV		R0,  R3 
-		BX		LR 
-		NOP 
-ProcessExit 
-		LDR		LR, =ProcessExit 	// Return to ProcessExit on next return 
-		LDRD	R1, R2, [SP, #8] 	// Arg0->R1, Arg1->R2 
-		LDR		R3, [SP, #16] 		// Load Counter 
-		ADD		R3,  #1 					// Increase 
-		STR		R3, [SP, #16] 		// Store back 
-		MOV		R0,  SP 					// Self pointer in R0 
-		LDR		PC, [SP, #4] 
-}
-// Request for changing the process stack and switch into a Task. 
-static __asm int Lin_Call(TASK Task){ 
-		SVC		SVCn_LinTrigger 
-		BX		LR 
-}
-// Get Message Carrier Block from Pool. 
-// Currently using direct memory allocation. 
-static Lin_MsgBlk * Lin_MsgPoolGet(void){ 
-	return (Lin_MsgBlk *)malloc(sizeof(Lin_MsgBlk)); 
-}
-// Returning Message Carrier Block to Pool. 
-// Currently using directly memory free-up. 
-static void Lin_MsgPoolRet(Lin_MsgBlk * MsgBlk){ 
-	free(MsgBlk); 
-}
-// Enqueue the Message Carrier into a Task Message Queue. 
-static void Lin_MsgEnQ(TASK Task, Lin_MsgBlk * MsgBlk){ 
-	if(MsgBlk == NULL) return; 
-	Lin_CritEnter(); 
-	Task->MsgQty++; 
-	Lin_MsgBlk * Prev = Task->MsgTail; 
-	if(Prev == NULL) Task->MsgHead = MsgBlk; 
-	else Prev->Next = MsgBlk; 
-	Task->MsgTail = MsgBlk; 
-	MsgBlk->Next = NULL; 
-	Lin_DebugMsgOpTimes++; 
-	Lin_CritExit(); 
-}
-// Enqueue the Message Carrier into a Task Message Queue, but at the front. 
-static void Lin_MsgEnQF(TASK Task, Lin_MsgBlk * MsgBlk){ 
-	if(MsgBlk == NULL) return; 
-	Lin_CritEnter(); 
-	Task->MsgQty++; 
-	MsgBlk->Next = Task->MsgHead; 
-	Task->MsgHead = MsgBlk; 
-	if(Task->MsgTail == NULL) Task->MsgTail = MsgBlk; 
-	Lin_DebugMsgOpTimes++; 
-	Lin_CritExit(); 
-}
-// Dequeue the Message Carrier from a Task Message Queue. 
-static Lin_MsgBlk * Lin_MsgDeQ(TASK Task){ 
-	Lin_CritEnter(); 
-	Lin_MsgBlk * MsgBlk = Task->MsgHead; 
-	if(MsgBlk == NULL){ 
-		Lin_CritExit(); 
-		return NULL; 
-	}
-	Task->MsgQty--; 
-	Task->MsgHead = MsgBlk->Next; 
-	if(Task->MsgHead == NULL) Task->MsgTail = NULL; 
-	MsgBlk->Next = NULL; 
-	Lin_CritExit(); 
-	Lin_DebugMsgOpTimes++; 
-	return MsgBlk; 
-}
-// System Service Call Handler. 
-// Other SVC Numbers, redirected to 
-// void SVC_ProxyCaller(u8 ID, u32 * StkF); 
-// SwitchISR function also located here for performance. 
-// The 1.0.6 version framework not changed 
-__asm void SVC_Handler(void){ 
-		// SVC Call Handler 
-		// Other SVC Numbers will trigger SVC_ProxyCaller(u8 ID, u32 * StkF); 
-		TST		LR,  #4 
-		ITE 	EQ 
-		MRSEQ R1,  MSP 
-		MRSNE R1,  PSP 								// Get HW Stack Frame Pointer. 
-		LDR		R0, [R1, #24] 
-		LDRB	R0, [R0, #-2] 					// Got HW StkF ptr in R1, SVC ID in R0. 
-		CMP		R0,  #SVCn_LinSwitch 
-		BNE		NotSwitch 							// Is Switch Op? 
-Switch 														//  Do Switch Op 
-		LDR		R0, [R1] 								//  Get Target Task Handle 
-	EXPORT	Lin_SwitchISR 
-Lin_SwitchISR 										//  Switches from ISR directly come here 
-		LDR		R2, =Lin_NextTask 
-		LDR		R1, [R2] 								//  Get Handle in Lin_NextTask 
-		CMP		R0,  R1 								//  Handles Compared 
-		ITTTT	NE 											//  If not equal- 
-		STRNE	R0, [R2] 								//   put new handle in Lin_NextTask 
-		LDRNE	R1, =0xE000ED00 
-		MOVNE	R0,  #0x10000000 
-		STRNE	R0, [R1, #4] 						//   PendSV Pend Set (SCB->ICSR.28) 
-		BX		LR 											//  Then PendSV executes on demand 
-NotSwitch 												// Not Switch Op 
-		CMP		R0,  #SVCn_LinTrigger		//  Is Trigger Op? 
-		BNE.W	SVC_ProxyCaller 				//   No, go to SVC_ProxyCaller 
-		TST		LR,  #4 								//  Is Trigger Op Enter or Return? 
-		BNE		Return 									//   Trigger Op is Enter 
-		MSR		PSP, R1 								//    Set PSP as current pointer for CtxS 
-		SUB		R2,  R1, #32 
-		MSR		MSP, R2 								//    MSP Stack Growth for CtxS (8 words) 
-		ORR 	LR,  #4 								//    Modify LR to use PSP 
-	IMPORT	Lin_TaskLoader 
-		LDR		R0, =Lin_TaskLoader 
-		LDR		R2, =Lin_CurrTask 
-		STR		R0, [R2] 								//    Set the storing handle to Lin_CurrTask 
-		B			Switch 
-Return 														//   Trigger Op is Return 
-		BIC		LR,  #4 								//    Modify LR, use MSP 
-		LDR		R3, [R1] 								//    Get return value, PensSV didn't use R3 
-		LDR		R1, =Lin_TaskLoader 
-		LDR		R2, =Lin_NextTask  
-		STR		R1, [R2] 								//    Store the storage handle to Lin_NextTask 
-		MOV		R12,  LR 								//    PendSV didn't use R12 
-		BL 		__cpp(PendSV_Handler) 	//    Do CtxSw 
-		MOV		LR,  R12 
-		MRS		R0,  PSP 
-		MSR		MSP, R0 								//    MSP Stack Shrink for CtxS 
-		STR		R3, [R0] 								//    Return value stored in HWStkF 
-		BX		LR 
-	EXPORT	SVC_ProxyCaller		[WEAK] 
-SVC_ProxyCaller 									// If SVC_ProxyCaller not present- 
-		BX		LR 											// Return 
-}
-// Pending Service Handler. 
-// Dedicated for Context Switching. 
-// The 1.0.6 version framework not changed 
-__asm void PendSV_Handler(void){ 
-		// PendSV Handler (Context Switch Performer) 
-		// Disable interrupts will prevent any context switches. 
-	IMPORT	Lin_DebugCtxSwTimes 
-		LDR		R1, =Lin_DebugCtxSwTimes 
-		LDR		R0, [R1] 
-		ADD		R0,  #1 
-		STR		R0, [R1] 
-		NOP 
-	IMPORT	Lin_CurrTask 
-	IMPORT	Lin_NextTask 
-		LDR		R2, =Lin_CurrTask 
-		LDR		R1, =Lin_NextTask 
-		LDR		R0, [R2] 			// CurrTaskHandle in R0 
-		LDR		R1, [R1] 			// NextTaskHandle in R1 
-		STR		R1, [R2] 			// NextTaskHandle stored in _CurrTask 
-		MRS		R2,  PSP 			// A1 Get   PSP1 from Processor 
-		STMDB R2!,{R4-R11} 	// A2 Push  Context {R4-R11} to PSP1  
-		STR		R2, [R0]			// A3 Store PSP1 via CurrTaskHandle->StkPtr 
-		LDR		R2, [R1]			// B1 Get   PSP2 via NextTaskHandle->StkPtr 
-		LDMIA R2!,{R4-R11} 	// B2 Pop   Context {R4-R11} from PSP2 
-		MSR		PSP, R2 			// B3 Set   PSP2 to Processor 
-		BX		LR 						// Pop HW Context {R0-R3,R12,LR,PC,PSR} 
-}
-// End of a section. 
-
-
-// End of file. 
+// Lin Architecture version 4.8.1 for lyrinka OS 
+/* The Lin Architecture Framework. 
+	Major changes in stack data structures 
+	providing a smart and flexiable interface 
+	but incompatable with older versions. 
+	
+	The memory operation and messaging operation still uses micro lib, 
+	which may hit performance. 
+	Please enable micro lib and configure sufficent heap area in startup_stm32f10x_md.s 
+	
+	Release notes: 
+	
+	<4.8.1 > 261019 A recycled stack block is not painted again, Lin_New only rebuilds its ECB and TCB. 
+	<4.8.0 > 261019 Removed the core count, the core id and the core and affinity fields of the ECB, 
+					nothing switched tasks on a second core. The critical region profiler keeps one table. 
+	<4.7.4 > 261019 MsgDrop hands the dropped Message back, so payload owners can release it. 
+	<4.7.3 > 261019 Lin_Cores and Lin_CoreId can be set by the build. Switching stays single-core, see Sched. 
+	<4.7.2 > 261019 ECB holds the calls a server has accepted. 
+	<4.7.1 > 261019 ECB holds the mailbox a blocked sender is queued on. 
+	<4.7.0 > 261019 Message priority lanes: PutL, Drop. Receiving takes the highest lane first, lane 0 is the old queue. 
+	<4.6.1 > 261019 ECB holds the synchronous call state of OS. 
+	<4.6.0 > 261019 Critical region profiler under Lin_CsProf: CsEnter, CsExit, CsReport and CsReset. 
+	<4.5.0 > 261019 Debug counters are updated through the atomic Met macros, MsgDeQ no longer counts outside its critical region. 
+	<4.4.1 > 261019 Added the histogram reference of the ECB. 
+	<4.4.0 > 261019 Added the core count and core id configuration, and the core and affinity fields of the ECB. 
+	<4.3.0 > 261019 Deleted Tasks are recycled: their stack blocks go to per-size bins reused by Lin_New. 
+					Lin_Delete releases all carriers in one pass instead of dequeueing them one by one. 
+	<4.2.0 > 261019 Stacks painted on creation when Lin_StkPaint is set, high-water mark read by StkFree. 
+	<4.1.1 > 261019 DWT Cycle Counter started in InitSw, read by Lin_CycCnt. 
+	<4.1.0 > 261019 Message carriers come from a real pool, preallocated with Lin_MsgPoolSize blocks. 
+					Added batched messaging: MsgPutN, MsgRecvN and MsgSplice, each in a single critical region. 
+	<4.0.2 > 261019 Event List in ECB sized by Lin_EvListMax, resolving the flexarray pending improvement. 
+	<4.0.1 > 190316 Header file now works in C++. Pending improvements on the flexarray at line 102. 
+	<4.0.0 > 190301 ThreadExit changed to ProcessExit. 
+					Minor modification on task prototype, easy access of Self pointer, now: 
+						void funcTask(TASK Self, int Arg0, int Arg1, u32 Cnt); 
+	<3.1.3 > 190206 Changed some debug info to unsigned. 
+	<3.1.2 > 190127 Changed TCB Data Structure for Event Managements. 
+									Added Event Control Block Data Structure. 
+									DataStructure optimized for Operating System using Lin. 
+									Updated StkInit for new data structures. New Tasks are created Dead (i.e. NULLS on all surrounding pointers) 
+									Initializations of chained lists are included for Lint is an addon of Lin. 
+									But OS related control information is not initialized. These are thrown directly to the operating system. 
+	<3.1.1 > 181225 Added support in data structure for priority queue and waiting list chained lists. 
+									Added macros for entering/exiting critical regions. 
+									Code not changed. 
+	<3.0.2 > 181115	Debugged and fully commented. 
+	<3.0.1 > 181113	Using Message Pool & Carrier design 
+									Using Single-chained Lists for Message Carriers. 
+	<3.0.0 > 181112	Copies of last version 2.1.2 
+*/ 
+
+#include <stm32f10x.h> 
+#include "Lin.h" 
+
+
+// using micro lib 
+void * 	malloc(u32 Size); 
+void 		free(void * Mem); 
+
+
+// Private variables & functions 
+TASK 					Lin_CurrTask; 		// Indicates the Current running Task reference 
+TASK 					Lin_NextTask; 		// Indicates the Next Task to be run referrence 
+TASK 					Lin_MainTask; 		// Indicates the Main Task reference 
+void * 				Lin_TaskLoader; 	// Storage for MSP on loading of the first task 
+
+int Lin_DebugMemLeak; 					// Shows any allocations without deallocation 
+u32 Lin_DebugMemAllocTimes; 		// Total times of memory allocations 
+u32 Lin_DebugMsgOpTimes; 				// Total times of message queue operations 
+u32 Lin_DebugCtxSwTimes; 				// Total times of context switching 
+
+Lin_MsgBlk * 	Lin_MsgPool; 			// Free Carrier Blocks 
+u32 					Lin_MsgPoolCnt; 	// Nbr of free Carrier Blocks 
+u32 					Lin_MsgPoolCap; 	// Carrier Blocks kept in the pool at most 
+
+u32 					Lin_RecySize[Lin_RecyBins]; 	// Stack size served by each bin, 0 for unused 
+void * 				Lin_RecyList[Lin_RecyBins]; 	// Dead stack blocks, chained through their first word 
+u32 					Lin_RecyCnt[Lin_RecyBins]; 		// Nbr of blocks in each bin 
+
+void 					Lin_InitMem		(u8 * MemS, u8 * MemE); 						// Initializes memory framework 
+void 					Lin_InitSw		(void); 														// Initializes context switching framework 
+void 					Lin_InitMsg		(u32 PoolSize); 										// Initializes message carrier pool framework 
+TASK 					Lin_StkInit		(u8 * Mem, u32 Size, void * Func); 	// Initialization of a new Task 
+int 					Lin_Call			(TASK Task); 												// Request for first context switch from MSP 
+Lin_MsgBlk * 	Lin_MsgPoolGet(void); 														// Get carrier block from message pool 
+void 					Lin_MsgPoolRet(Lin_MsgBlk * MsgBlk); 							// Return carrier block from message pool 
+void 					Lin_MsgEnQ		(TASK Task, Lin_MsgBlk * MsgBlk); 	// Enqueue message carrier 
+void 					Lin_MsgEnQF		(TASK Task, Lin_MsgBlk * MsgBlk); 	// Enqueue message carrier, but at the front 
+Lin_MsgBlk * 	Lin_MsgDeQ		(TASK Task); 												// Dequeue message carrier 
+Lin_MsgBlk * 	Lin_MsgDeQL		(TASK Task, int Lane); 							// Dequeue message carrier from a lane 
+
+// Exception Handlers 
+void 												PendSV_Handler(void); 	// Pending Service Handler 
+void 												SVC_Handler		(void); 	// System Service Call Handler 
+
+// Macros 
+#ifndef Lin_CsProf 
+#define Lin_CritEnter() u32 __Lin_IE = __get_PRIMASK(); __disable_irq() 	// Enter critical region 
+#define Lin_CritExit() __set_PRIMASK(__Lin_IE) 														// Exit critical region 
+#else 
+#define Lin_CritEnter() u32 __Lin_IE = Lin_CsEnter((void *)__current_pc(), (void *)__return_address()) 
+#define Lin_CritExit() Lin_CsExit(__Lin_IE) 
+#endif 
+
+#define Lin_LaneTop(ECB) ((ECB)->MsgLaneMap == 0 ? 0 : 31 - __clz((ECB)->MsgLaneMap)) 	// Highest non-empty lane 
+
+// External Functions 
+extern void SVC_ProxyCaller(u8 ID, u32 * StkF); 	// Other SVC Calls redirected to here. weakly defined. 
+
+
+// Function Definitions. 
+// ************************************************************************************ 
+// System Startup: 
+// Initialize the whole system including: 
+/*	Memory Management 
+		Task Management 
+		Interrupts & Context Switching 
+		Inter-Task Messaging 
+*/
+void Lin_Init(void){ 
+	Lin_InitMem((u8 *)Lin_MemStart, (u8 *)Lin_MemEnd); 
+	Lin_InitSw(); 
+	Lin_InitMsg(Lin_MsgPoolSize); 
+}
+// End of a section. 
+
+
+// ************************************************************************************ 
+// Memory Managements: 
+// Allocate a chunk of memory: 
+/*	If failed the function return a NULL pointer. 
+		Sizes are in Bytes. 
+		Returned pointer is Word-Aligned. 
+*/
+void * Lin_MemAlloc(u32 Size){ 
+	Lin_CritEnter(); 
+	Met_Inc(Lin_DebugMemLeak); 
+	Met_Inc(Lin_DebugMemAllocTimes); 
+	void * Mem = malloc(Size); 
+	Lin_CritExit(); 
+	return Mem; 
+}
+// Free up a chunk of memory: 
+/*	If input pointer is not valid 
+		the function ignore the freeing operation. 
+*/
+void Lin_MemFree(void * Mem){ 
+	Lin_CritEnter(); 
+	Met_Dec(Lin_DebugMemLeak); 
+	free(Mem); 
+	Lin_CritExit(); 
+}
+// End of a section. 
+
+
+// ************************************************************************************ 
+// Task Management: 
+// Create ane Initialize a new Task: 
+/*	This function allocates memory. 
+		StkSize in Bytes. 
+		PC could be any function pointer but 
+		the best would be 
+		void Task(int Arg0, int Arg1, u32 Counter, TASK * Self); 
+*/
+TASK Lin_New(u32 StkSize, void * PC){ 
+	void * Mem = NULL; 
+	int Recycled = 0; 
+	Lin_CritEnter(); 
+	for(int i = 0; i < Lin_RecyBins; i++){ 	// A recycled block of this size? 
+		if(Lin_RecySize[i] == StkSize && Lin_RecyList[i] != NULL){ 
+			Mem = Lin_RecyList[i]; 
+			Lin_RecyList[i] = *(void **)Mem; 
+			Lin_RecyCnt[i]--; 
+			Recycled = 1; 
+			break; 
+		}
+	}
+	Lin_CritExit(); 
+	if(Mem == NULL) Mem = Lin_MemAlloc(StkSize); 
+	if(Mem == NULL) return (TASK)NULL; 
+#if Lin_StkPaint 
+	if(!Recycled){ 	// A recycled block keeps the paint left below the deepest use of its earlier tasks. 
+		u32 * Word = (u32 *)((u8 *)Mem + ((sizeof(Lin_ECB) + 3) & ~3)); 	// ECB to TCB, StkInit fills in the first frame afterwards. 
+		u32 * Top = (u32 *)((u8 *)Mem + StkSize - sizeof(Lin_TCB)); 
+		while(Word < Top) *Word++ = Lin_StkMagic; 
+	}
+#endif 
+	TASK Task = Lin_StkInit(Mem, StkSize, PC); 
+	Task->ECB->MsgLaneMap = 0; 
+	return Task; 
+}
+// Set the arguments of a Task. 
+/*	These values are read only on the 
+		re-entering of a task. 
+*/
+void Lin_SetArgs(TASK Task, int Arg0, int Arg1){ 
+	Task->Arg0 = Arg0; 
+	Task->Arg1 = Arg1; 
+}
+// Set the entrance point of a Task. 
+/*	The entrance point is not active till the
+		re-entering of a task. 
+*/
+void Lin_SetPC(TASK Task, void * PC){ 
+	Task->PC = PC; 
+}
+// Enter a Task from normal program. 
+/*	The normal C program uses MSP. 
+		The Task Framework uses separate PSPs for each Task. 
+		The Task being entered first becomes the MainTask, 
+		providing easy access from anywhere within the framework. 
+		Like Standard C Call, 
+		The task framework may return an int value. 
+*/
+int Lin_Enter(TASK Task){ 
+	Lin_MainTask = Task; 
+	return Lin_Call(Task); 
+}
+// Return to normal program from any Task. 
+/*	Like Standard C Call, 
+		The task framework may return an int value. 
+		It is the normal program's responsibility 
+		to release all Task Stack Memories. 
+*/
+__asm void Lin_Return(int retval){ 
+		SVC		SVCn_LinTrigger 
+		BX		LR 
+}
+// Delete a task by releasing all its memory. 
+/*	This function does not really disabling the task. 
+		It just releases all the associated memory, 
+		including StackMemory and all Message Blocks(Carriers). 
+		Re-entering this task may cause serious violations 
+		for the stack and the TCB structure may be corrupted 
+		by other allocations of the memory. 
+		The StackMemory is kept for the next Lin_New of the same size 
+		while its recycle bin has room, and freed up otherwise. 
+*/
+void Lin_Delete(TASK Task){ 
+	Lin_CritEnter(); 
+	Lin_MsgBlk * MsgBlk = Task->MsgHead; 	// Release all carriers at once. 
+	while(MsgBlk != NULL){ 
+		Lin_MsgBlk * Next = MsgBlk->Next; 
+		Lin_MsgPoolRet(MsgBlk); 
+		MsgBlk = Next; 
+	}
+	Task->MsgHead = NULL; 
+	Task->MsgTail = NULL; 
+	for(u32 Map = Task->ECB->MsgLaneMap; Map != 0; Map &= Map - 1){ 	// And those in the lanes. 
+		MsgBlk = Task->ECB->MsgLaneHead[30 - __clz(Map & -Map)]; 
+		while(MsgBlk != NULL){ 
+			Lin_MsgBlk * Next = MsgBlk->Next; 
+			Lin_MsgPoolRet(MsgBlk); 
+			MsgBlk = Next; 
+		}
+	}
+	Task->ECB->MsgLaneMap = 0; 
+	Task->MsgQty = 0; 
+	void * Mem = Task->ECB; 
+	u32 Size = Lin_StkSize(Task); 
+	int Bin = -1; 
+	for(int i = 0; i < Lin_RecyBins; i++){ 	// The bin of this size, or a free one. 
+		if(Lin_RecySize[i] == Size){ 
+			Bin = i; 
+			break; 
+		}
+		if(Bin < 0 && Lin_RecyCnt[i] == 0) Bin = i; 
+	}
+	if(Bin >= 0 && Lin_RecyCnt[Bin] < Lin_RecyDepth){ 
+		if(Lin_RecySize[Bin] != Size){ 	// Claim a free bin. 
+			Lin_RecySize[Bin] = Size; 
+			Lin_RecyList[Bin] = NULL; 
+		}
+		*(void **)Mem = Lin_RecyList[Bin]; 
+		Lin_RecyList[Bin] = Mem; 
+		Lin_RecyCnt[Bin]++; 
+	}
+	else Lin_MemFree(Mem); 
+	Lin_CritExit(); 
+}
+// End of a section. 
+
+
+// ************************************************************************************ 
+// Context Switching: 
+// Switching inbetween Task. 
+__asm void Lin_Switch(TASK Task){ 
+		SVC		SVCn_LinSwitch 
+		BX		LR 
+}
+// Switching inbetween Task from ISR. 
+void Lin_SwitchISR(TASK Task); 
+/*	This function stays in the 
+//	void SVC_Handler(void); 
+//	for the optimization of speed. 
+*/
+// Switching to the MainTask. 
+void Lin_Yield(void){ 
+	Lin_Switch(Lin_MainTask); 
+}
+// Switching to the MainTask from ISR. 
+void Lin_YieldISR(void){ 
+	Lin_SwitchISR(Lin_MainTask); 
+}
+// End of a section. 
+
+
+// ************************************************************************************ 
+// Miscellaneous: 
+// Get Current Executing Task. 
+/*	Still applicable from ISR, 
+		Indicating the interrupted Task. 
+*/
+TASK Lin_GetCurrTask(void){ 
+	return Lin_CurrTask; 
+}
+// Get MainTask. 
+TASK Lin_GetMainTask(void){ 
+	return Lin_MainTask; 
+}
+// Get the Stack size of a Task. 
+/*	In Bytes, including ECB and TCB, 
+		as given to Lin_New. 
+*/
+u32 Lin_StkSize(TASK Task){ 
+	return (u8 *)Task + sizeof(Lin_TCB) - (u8 *)Task->ECB; 
+}
+// Get the Stack never touched by a Task. 
+/*	In Bytes, the high-water mark is StkSize minus this. 
+		Scans up from the bottom of the paint, 
+		so the cost is proportional to the answer. 
+		Always 0 if stacks are not painted. 
+		A recycled stack block is not painted again, 
+		so its mark covers every Task that has used the block. 
+*/
+u32 Lin_StkFree(TASK Task){ 
+#if Lin_StkPaint 
+	u32 * Word = (u32 *)((u8 *)Task->ECB + ((sizeof(Lin_ECB) + 3) & ~3)); 
+	u32 * Top = (u32 *)Task; 
+	u32 * Start = Word; 
+	while(Word < Top && *Word == Lin_StkMagic) Word++; 
+	return (u8 *)Word - (u8 *)Start; 
+#else 
+	return 0; 
+#endif 
+}
+// End of a section. 
+
+
+// ************************************************************************************ 
+// Inter-Task Messaging: 
+// Enqueue Message to a Task. 
+/*	If there is not enough memory for getting the Carrier Block, 
+		The function returns -1, 
+		Else it returns 0. 
+		Same for all other functions indicated below. 
+*/
+int Lin_MsgPut(TASK Task, MSG Msg){ 
+	Lin_MsgBlk * MsgBlk = Lin_MsgPoolGet(); 
+	if(MsgBlk == NULL) return -1; 
+	MsgBlk->Msg = Msg; 
+	Lin_MsgEnQ(Task, MsgBlk); 
+	return 0; 
+}
+// Enqueue Message to a Task, but at opposite front. 
+/*	Note: Same as MsgPut. 
+*/
+int Lin_MsgPutF(TASK Task, MSG Msg){ 
+	Lin_MsgBlk * MsgBlk = Lin_MsgPoolGet(); 
+	if(MsgBlk == NULL) return -1; 
+	MsgBlk->Msg = Msg; 
+	Lin_MsgEnQF(Task, MsgBlk); 
+	return 0; 
+}
+// Enqueue several Messages to a Task at once. 
+/*	Carriers are taken and linked in a single critical region. 
+		Either all N Messages are enqueued in order and the function returns 0, 
+		or none of them is and it returns -1. 
+*/
+int Lin_MsgPutN(TASK Task, const MSG * Msg, u32 N){ 
+	if(N == 0) return 0; 
+	Lin_CritEnter(); 
+	Lin_MsgBlk * Head = NULL; 
+	Lin_MsgBlk * Tail = NULL; 
+	for(u32 i = 0; i < N; i++){ 
+		Lin_MsgBlk * MsgBlk = Lin_MsgPoolGet(); 
+		if(MsgBlk == NULL){ 	// Out of memory, give back what we got. 
+			while(Head != NULL){ 
+				Tail = Head->Next; 
+				Lin_MsgPoolRet(Head); 
+				Head = Tail; 
+			}
+			Lin_CritExit(); 
+			return -1; 
+		}
+		MsgBlk->Msg = Msg[i]; 
+		MsgBlk->Next = NULL; 
+		if(Tail == NULL) Head = MsgBlk; 
+		else Tail->Next = MsgBlk; 
+		Tail = MsgBlk; 
+	}
+	if(Task->MsgTail == NULL) Task->MsgHead = Head; 
+	else Task->MsgTail->Next = Head; 
+	Task->MsgTail = Tail; 
+	Task->MsgQty += N; 
+	Met_Inc(Lin_DebugMsgOpTimes); 
+	Lin_CritExit(); 
+	return 0; 
+}
+// Enqueue Message to a Task in a priority lane. 
+/*	Lanes run from 0, the queue used by MsgPut, to Lin_MsgLanes - 1. 
+		Receiving always takes the oldest Message of the highest non-empty lane, 
+		so urgent Messages neither wait behind bulk ones nor overtake each other. 
+		Lanes beyond the last are clamped to it. 
+		Note: Same as MsgPut. 
+*/
+int Lin_MsgPutL(TASK Task, MSG Msg, int Lane){ 
+	if(Lane <= 0) return Lin_MsgPut(Task, Msg); 
+	if(Lane >= Lin_MsgLanes) Lane = Lin_MsgLanes - 1; 
+	Lin_MsgBlk * MsgBlk = Lin_MsgPoolGet(); 
+	if(MsgBlk == NULL) return -1; 
+	MsgBlk->Msg = Msg; 
+	MsgBlk->Next = NULL; 
+	Lin_ECB * ECB = Task->ECB; 
+	Lin_CritEnter(); 
+	if(ECB->MsgLaneMap & (1u << Lane)) ECB->MsgLaneTail[Lane - 1]->Next = MsgBlk; 
+	else{ 
+		ECB->MsgLaneHead[Lane - 1] = MsgBlk; 
+		ECB->MsgLaneMap |= 1u << Lane; 
+	}
+	ECB->MsgLaneTail[Lane - 1] = MsgBlk; 
+	Task->MsgQty++; 
+	Met_Inc(Lin_DebugMsgOpTimes); 
+	Lin_CritExit(); 
+	return 0; 
+}
+// Drop the oldest Message of the lowest non-empty lane of a Task. 
+/*	Makes room in a full mailbox at the expense of bulk traffic. 
+		Returns 0, or -1 if there was nothing to drop. 
+*/
+int Lin_MsgDrop(TASK Task, MSG * Msg){ 	// The dropped Message goes to Msg unless NULL. 
+	Lin_CritEnter(); 
+	int Lane = 0; 
+	u32 Map = Task->ECB->MsgLaneMap; 
+	if(Task->MsgHead == NULL && Map != 0) Lane = 31 - __clz(Map & -Map); 	// Lowest set bit. 
+	Lin_MsgBlk * MsgBlk = Lin_MsgDeQL(Task, Lane); 
+	Lin_CritExit(); 
+	if(MsgBlk == NULL) return -1; 
+	if(Msg != NULL) *Msg = MsgBlk->Msg; 
+	Lin_MsgPoolRet(MsgBlk); 
+	return 0; 
+}
+// Move the whole Message Queue of one Task to the back of another. 
+/*	No Carrier is allocated or released. 
+		Each lane goes to the back of the same lane. 
+		Returns the number of Messages moved. 
+*/
+u32 Lin_MsgSplice(TASK Dst, TASK Src){ 
+	Lin_CritEnter(); 
+	u32 N = Src->MsgQty; 
+	if(N == 0 || Dst == Src){ 
+		Lin_CritExit(); 
+		return 0; 
+	}
+	if(Src->MsgHead != NULL){ 
+		if(Dst->MsgTail == NULL) Dst->MsgHead = Src->MsgHead; 
+		else Dst->MsgTail->Next = Src->MsgHead; 
+		Dst->MsgTail = Src->MsgTail; 
+	}
+	Lin_ECB * SrcECB = Src->ECB; 
+	Lin_ECB * DstECB = Dst->ECB; 
+	for(u32 Map = SrcECB->MsgLaneMap; Map != 0; Map &= Map - 1){ 
+		int i = 30 - __clz(Map & -Map); 	// Lowest lane left, i + 1. 
+		if(DstECB->MsgLaneMap & (2u << i)) DstECB->MsgLaneTail[i]->Next = SrcECB->MsgLaneHead[i]; 
+		else DstECB->MsgLaneHead[i] = SrcECB->MsgLaneHead[i]; 
+		DstECB->MsgLaneTail[i] = SrcECB->MsgLaneTail[i]; 
+	}
+	DstECB->MsgLaneMap |= SrcECB->MsgLaneMap; 
+	SrcECB->MsgLaneMap = 0; 
+	Dst->MsgQty += N; 
+	Src->MsgHead = NULL; 
+	Src->MsgTail = NULL; 
+	Src->MsgQty = 0; 
+	Met_Inc(Lin_DebugMsgOpTimes); 
+	Lin_CritExit(); 
+	return N; 
+}
+// Enqueue Message to MainTask. 
+/*	Note: Same as MsgPut. 
+*/
+int Lin_MsgSubmit(MSG Msg){ 
+	return Lin_MsgPut(Lin_MainTask, Msg); 
+}
+// Enqueue Message to MainTask, but at opposite front. 
+/*	Note: Same as MsgPut. 
+*/
+int Lin_MsgSubmitF(MSG Msg){ 
+	return Lin_MsgPutF(Lin_MainTask, Msg); 
+}
+// Get number in the waiting queue of the Current Task. 
+/*	Still applicable from ISR, 
+		Indicating the queue status of the interrupted Task. 
+*/
+u32 Lin_MsgQty(void){ 
+		return Lin_CurrTask->MsgQty; 
+}
+// Dequeue Message from any Task, and releasing associated memory. 
+/*	If there is no message in the queue, 
+		the function returns an empty Message content. 
+		Always check queue status before dequeueing the message queue. 
+		Same for all other functions indicated below. 
+*/
+MSG Lin_MsgGet(TASK Task){ 
+	Lin_MsgBlk * MsgBlk = Lin_MsgDeQ(Task); 
+	MSG Msg; 
+	Msg.Src = 0; 
+	Msg.Cmd = 0; 
+	Msg.Pld = NULL; 
+	if(MsgBlk == NULL) return Msg; 
+	Msg = MsgBlk->Msg; 
+	Lin_MsgPoolRet(MsgBlk); 
+	return Msg; 
+}
+// Dequeue Message from Current Task, and releasing associated memory. 
+/*	Note: See MsgGet. 
+*/
+MSG	Lin_MsgRecv(void){ 
+	return Lin_MsgGet(Lin_CurrTask); 
+}
+// Dequeue up to Max Messages from Current Task at once. 
+/*	All Carriers are detached and released in a single critical region. 
+		Returns the number of Messages stored into Msg. 
+*/
+u32 Lin_MsgRecvN(MSG * Msg, u32 Max){ 
+	TASK Task = Lin_CurrTask; 
+	Lin_ECB * ECB = Task->ECB; 
+	u32 N = 0; 
+	Lin_CritEnter(); 
+	while(ECB->MsgLaneMap != 0 && N < Max){ 	// Lanes first, highest down. 
+		int i = Lin_LaneTop(ECB) - 1; 
+		Lin_MsgBlk * MsgBlk = ECB->MsgLaneHead[i]; 
+		while(MsgBlk != NULL && N < Max){ 
+			Lin_MsgBlk * Next = MsgBlk->Next; 
+			Msg[N++] = MsgBlk->Msg; 
+			Lin_MsgPoolRet(MsgBlk); 
+			MsgBlk = Next; 
+		}
+		ECB->MsgLaneHead[i] = MsgBlk; 
+		if(MsgBlk == NULL) ECB->MsgLaneMap &= ~(2u << i); 
+	}
+	Lin_MsgBlk * MsgBlk = Task->MsgHead; 
+	while(MsgBlk != NULL && N < Max){ 
+		Lin_MsgBlk * Next = MsgBlk->Next; 
+		Msg[N++] = MsgBlk->Msg; 
+		Lin_MsgPoolRet(MsgBlk); 
+		MsgBlk = Next; 
+	}
+	Task->MsgHead = MsgBlk; 
+	if(MsgBlk == NULL) Task->MsgTail = NULL; 
+	Task->MsgQty -= N; 
+	if(N != 0) Met_Inc(Lin_DebugMsgOpTimes); 
+	Lin_CritExit(); 
+	return N; 
+}
+// Preview Message in the Current Task queue. 
+/*	Previewing does not remove the carrier block from the queue. 
+		It just snaps the value into a variable then returns it. 
+		Note: See MsgGet. 
+*/
+MSG Lin_MsgPrvw(void){ 
+	Lin_CritEnter(); 
+	Lin_ECB * ECB = Lin_CurrTask->ECB; 
+	Lin_MsgBlk * MsgBlk = ECB->MsgLaneMap != 0 ? ECB->MsgLaneHead[Lin_LaneTop(ECB) - 1] : Lin_CurrTask->MsgHead; 
+	MSG Msg; 
+	Msg.Src = 0; 
+	Msg.Cmd = 0; 
+	Msg.Pld = NULL; 
+	if(MsgBlk != NULL) Msg = MsgBlk->Msg; 
+	Lin_CritExit(); 
+	return Msg; 
+}
+// End of a section. 
+
+
+#ifdef Lin_CsProf 
+// ************************************************************************************ 
+// Critical Region Profiler: 
+// Every critical region of the kernel and of OS.h users goes through here. 
+/*	Only the outermost region of a nest is timed, from masking to unmasking, 
+		so the figures are the interrupt latency added by each call site. 
+		The profiler keeps the Lin_CsTop sites with the longest interval seen. 
+		Intervals below the shortest kept one are rejected after a single compare. 
+		Sites are code addresses, look them up in the map file. 
+*/
+typedef struct Lin_CsCtx{ 
+	u32 Stamp; 								// Cycle Counter at masking 
+	void * Site; 
+	void * Caller; 
+	u32 Floor; 								// Shortest Max in a full table 
+	Lin_CsRec Rec[Lin_CsTop]; 
+}Lin_CsCtx; 
+Lin_CsCtx Lin_Cs; 
+
+u32 Lin_CsEnter(void * Site, void * Caller){ 
+	u32 IE = __get_PRIMASK(); 
+	__disable_irq(); 
+	if(IE == 0){ 
+		Lin_CsCtx * Ctx = &Lin_Cs; 
+		Ctx->Site = Site; 
+		Ctx->Caller = Caller; 
+		Ctx->Stamp = Lin_CycCnt(); 
+	}
+	return IE; 
+}
+void Lin_CsExit(u32 IE){ 
+	if(IE == 0){ 
+		Lin_CsCtx * Ctx = &Lin_Cs; 
+		u32 Cycles = Lin_CycCnt() - Ctx->Stamp; 
+		if(Cycles > Ctx->Floor){ 
+			int Min = 0; 
+			for(int i = 0; i < Lin_CsTop; i++){ 
+				Lin_CsRec * Rec = &Ctx->Rec[i]; 
+				if(Rec->Site == Ctx->Site){ 	// Known site: raise its Max. 
+					if(Cycles > Rec->Max) Rec->Max = Cycles; 
+					Rec->Hits++; 
+					Min = -1; 
+					break; 
+				}
+				if(Rec->Max < Ctx->Rec[Min].Max) Min = i; 
+			}
+			if(Min >= 0){ 	// New site: evict the shortest. 
+				Lin_CsRec * Rec = &Ctx->Rec[Min]; 
+				Rec->Site = Ctx->Site; 
+				Rec->Caller = Ctx->Caller; 
+				Rec->Max = Cycles; 
+				Rec->Hits = 1; 
+			}
+			u32 Floor = Ctx->Rec[0].Max; 
+			for(int i = 1; i < Lin_CsTop; i++) if(Ctx->Rec[i].Max < Floor) Floor = Ctx->Rec[i].Max; 
+			Ctx->Floor = Floor; 
+		}
+	}
+	__set_PRIMASK(IE); 
+}
+// Copy the table into Rec, longest first. Returns the number copied. 
+int Lin_CsReport(Lin_CsRec * Rec, int Max){ 
+	int N = 0; 
+	u32 IE = __get_PRIMASK(); 
+	__disable_irq(); 
+	for(int i = 0; i < Lin_CsTop; i++){ 
+		Lin_CsRec * Src = &Lin_Cs.Rec[i]; 
+		if(Src->Site == NULL) continue; 
+		int j; 	// Insertion sort, dropping the shortest when full. 
+		if(N < Max) j = N++; 
+		else if(Max > 0 && Rec[Max - 1].Max < Src->Max) j = Max - 1; 
+		else continue; 
+		while(j > 0 && Rec[j - 1].Max < Src->Max){ 
+			Rec[j] = Rec[j - 1]; 
+			j--; 
+		}
+		Rec[j] = *Src; 
+	}
+	__set_PRIMASK(IE); 
+	return N; 
+}
+// Clear the tables, e.g. once the system has booted. 
+void Lin_CsReset(void){ 
+	u32 IE = __get_PRIMASK(); 
+	__disable_irq(); 
+	Lin_Cs.Floor = 0; 
+	for(int i = 0; i < Lin_CsTop; i++){ 
+		Lin_Cs.Rec[i].Site = NULL; 
+		Lin_Cs.Rec[i].Caller = NULL; 
+		Lin_Cs.Rec[i].Max = 0; 
+		Lin_Cs.Rec[i].Hits = 0; 
+	}
+	__set_PRIMASK(IE); 
+}
+// End of a section. 
+#endif 
+
+
+// ************************************************************************************ 
+// Private Functions: 
+// Initialize the Memory Management framework. 
+// Currently dummy. 
+static void Lin_InitMem(u8 * MemS, u8 * MemE){ 
+	Lin_DebugMemLeak = 0; 
+	Lin_DebugMemAllocTimes = 0; 
+	for(int i = 0; i < Lin_RecyBins; i++){ 
+		Lin_RecySize[i] = 0; 
+		Lin_RecyList[i] = NULL; 
+		Lin_RecyCnt[i] = 0; 
+	}
+}
+// Initilize the Context Switching Environment. 
+// 1.0.6 Framework not changed. 
+static void Lin_InitSw(void){ 
+	// User Functions - NVIC and Handler Initialization 
+	SCB->CCR |= 1 << 9; 																	// Disable Stack DW Align 
+	SCB->AIRCR = (5 << 8) | (0x05FA << 16); 							// Priority Group 5, 2bits+2bits 
+	SCB->ICSR = 1 << 27; 																	// PendSV Pend Clear 
+	SCB->SHCSR &= ~(1 << 15); 														// SVC Pend Clear 
+	SCB->SHP[12+PendSV_IRQn] = (3 << 6) | (3 << 4) | 15; 	// PendSV Lowest Priority 
+	SCB->SHP[12+SVCall_IRQn] = (3 << 6) | (2 << 4); 			// SVC Pp same as PendSV, Sp higher than PendSV 
+	*((volatile u32 *)0xE000EDFC) |= 1 << 24; 						// DEMCR.TRCENA, enables DWT 
+	Lin_CycCnt() = 0; 
+	*((volatile u32 *)0xE0001000) |= 1; 									// DWT_CTRL.CYCCNTENA 
+	Lin_CurrTask = NULL; 
+	Lin_NextTask = NULL; 
+	Lin_MainTask = NULL; 
+	Lin_TaskLoader = NULL; 
+	Lin_DebugCtxSwTimes = 0; 
+}
+// Initilize the Messaging Framework. 
+// Preallocates PoolSize Carrier Blocks. 
+static void Lin_InitMsg(u32 PoolSize){ 
+	Lin_DebugMsgOpTimes = 0; 
+	Lin_MsgPool = NULL; 
+	Lin_MsgPoolCnt = 0; 
+	Lin_MsgPoolCap = PoolSize; 
+	for(u32 i = 0; i < PoolSize; i++){ 
+		Lin_MsgBlk * MsgBlk = (Lin_MsgBlk *)malloc(sizeof(Lin_MsgBlk)); 
+		if(MsgBlk == NULL) break; 
+		MsgBlk->Next = Lin_MsgPool; 
+		Lin_MsgPool = MsgBlk; 
+		Lin_MsgPoolCnt++; 
+	}
+}
+// Initilize the Stack of a new Task. 
+// ProcessExit routine also included. 
+static __asm TASK Lin_StkInit(u8 * Memory, u32 Size, void * funcPtr){ 
+		ADD		R3,  R0, R1 		
+		SUB		R3,  #64 
+		STR		R0, [R3, #60] // SL 
+		MOV		R0,  #0 
+		STR		R0, [R3, #44] // RBN 
+		STR		R0, [R3, #40] // LBN 
+		STR		R0, [R3, #36] // Next 
+		STR		R0, [R3, #32] // Prev 
+		STR		R0, [R3, #28] // MsgTail 
+		STR		R0, [R3, #24] // MsgHead
+		STR		R0, [R3, #20] // MsgQty 
+		STR		R0, [R3, #12] // Arg1 
+		STR		R0, [R3, #08] // Arg0 
+		MVN		R0,  R0 
+		STR		R0, [R3, #16] // Cntr 
+		STR		R2, [R3, #04] // PC 
+		SUB		R0,  R3, #64 
+		STR		R0, [R3] // SP 
+		MOV		R0, #0x01000000 
+		STR		R0, [R3, #-4] // xPSR 
+		LDR		R0, =ProcessExit 
+		STR		R0, [R3, #-8] // ThreadExit 
+		MOV		R0,  R3 
+		BX		LR 
+		NOP 
+ProcessExit 
+		LDR		LR, =ProcessExit 	// Return to ProcessExit on next return 
+		LDRD	R1, R2, [SP, #8] 	// Arg0->R1, Arg1->R2 
+		LDR		R3, [SP, #16] 		// Load Counter 
+		ADD		R3,  #1 					// Increase 
+		STR		R3, [SP, #16] 		// Store back 
+		MOV		R0,  SP 					// Self pointer in R0 
+		LDR		PC, [SP, #4] 
+}
+// Request for changing the process stack and switch into a Task. 
+static __asm int Lin_Call(TASK Task){ 
+		SVC		SVCn_LinTrigger 
+		BX		LR 
+}
+// Get Message Carrier Block from Pool. 
+// Falls back to direct memory allocation when the pool runs dry. 
+static Lin_MsgBlk * Lin_MsgPoolGet(void){ 
+	Lin_CritEnter(); 
+	Lin_MsgBlk * MsgBlk = Lin_MsgPool; 
+	if(MsgBlk != NULL){ 
+		Lin_MsgPool = MsgBlk->Next; 
+		Lin_MsgPoolCnt--; 
+	}
+	else MsgBlk = (Lin_MsgBlk *)malloc(sizeof(Lin_MsgBlk)); 
+	Lin_CritExit(); 
+	return MsgBlk; 
+}
+// Returning Message Carrier Block to Pool. 
+// Blocks beyond the pool capacity are freed up. 
+static void Lin_MsgPoolRet(Lin_MsgBlk * MsgBlk){ 
+	Lin_CritEnter(); 
+	if(Lin_MsgPoolCnt < Lin_MsgPoolCap){ 
+		MsgBlk->Next = Lin_MsgPool; 
+		Lin_MsgPool = MsgBlk; 
+		Lin_MsgPoolCnt++; 
+	}
+	else free(MsgBlk); 
+	Lin_CritExit(); 
+}
+// Enqueue the Message Carrier into a Task Message Queue. 
+static void Lin_MsgEnQ(TASK Task, Lin_MsgBlk * MsgBlk){ 
+	if(MsgBlk == NULL) return; 
+	Lin_CritEnter(); 
+	Task->MsgQty++; 
+	Lin_MsgBlk * Prev = Task->MsgTail; 
+	if(Prev == NULL) Task->MsgHead = MsgBlk; 
+	else Prev->Next = MsgBlk; 
+	Task->MsgTail = MsgBlk; 
+	MsgBlk->Next = NULL; 
+	Met_Inc(Lin_DebugMsgOpTimes); 
+	Lin_CritExit(); 
+}
+// Enqueue the Message Carrier into a Task Message Queue, but at the front. 
+static void Lin_MsgEnQF(TASK Task, Lin_MsgBlk * MsgBlk){ 
+	if(MsgBlk == NULL) return; 
+	Lin_CritEnter(); 
+	Task->MsgQty++; 
+	MsgBlk->Next = Task->MsgHead; 
+	Task->MsgHead = MsgBlk; 
+	if(Task->MsgTail == NULL) Task->MsgTail = MsgBlk; 
+	Met_Inc(Lin_DebugMsgOpTimes); 
+	Lin_CritExit(); 
+}
+// Dequeue the Message Carrier from a Task Message Queue. 
+// Highest non-empty lane first. 
+static Lin_MsgBlk * Lin_MsgDeQ(TASK Task){ 
+	Lin_CritEnter(); 
+	Lin_MsgBlk * MsgBlk = Lin_MsgDeQL(Task, Lin_LaneTop(Task->ECB)); 
+	Lin_CritExit(); 
+	return MsgBlk; 
+}
+// Dequeue the Message Carrier from a lane of a Task Message Queue. 
+static Lin_MsgBlk * Lin_MsgDeQL(TASK Task, int Lane){ 
+	Lin_CritEnter(); 
+	Lin_ECB * ECB = Task->ECB; 
+	Lin_MsgBlk * MsgBlk; 
+	if(Lane == 0){ 
+		MsgBlk = Task->MsgHead; 
+		if(MsgBlk != NULL){ 
+			Task->MsgHead = MsgBlk->Next; 
+			if(Task->MsgHead == NULL) Task->MsgTail = NULL; 
+		}
+	}
+	else{ 
+		MsgBlk = ECB->MsgLaneMap & (1u << Lane) ? ECB->MsgLaneHead[Lane - 1] : NULL; 
+		if(MsgBlk != NULL){ 
+			ECB->MsgLaneHead[Lane - 1] = MsgBlk->Next; 
+			if(MsgBlk->Next == NULL) ECB->MsgLaneMap &= ~(1u << Lane); 
+		}
+	}
+	if(MsgBlk == NULL){ 
+		Lin_CritExit(); 
+		return NULL; 
+	}
+	Task->MsgQty--; 
+	MsgBlk->Next = NULL; 
+	Met_Inc(Lin_DebugMsgOpTimes); 
+	Lin_CritExit(); 
+	return MsgBlk; 
+}
+// System Service Call Handler. 
+// Other SVC Numbers, redirected to 
+// void SVC_ProxyCaller(u8 ID, u32 * StkF); 
+// SwitchISR function also located here for performance. 
+// The 1.0.6 version framework not changed 
+__asm void SVC_Handler(void){ 
+		// SVC Call Handler 
+		// Other SVC Numbers will trigger SVC_ProxyCaller(u8 ID, u32 * StkF); 
+		TST		LR,  #4 
+		ITE 	EQ 
+		MRSEQ R1,  MSP 
+		MRSNE R1,  PSP 								// Get HW Stack Frame Pointer. 
+		LDR		R0, [R1, #24] 
+		LDRB	R0, [R0, #-2] 					// Got HW StkF ptr in R1, SVC ID in R0. 
+		CMP		R0,  #SVCn_LinSwitch 
+		BNE		NotSwitch 							// Is Switch Op? 
+Switch 														//  Do Switch Op 
+		LDR		R0, [R1] 								//  Get Target Task Handle 
+	EXPORT	Lin_SwitchISR 
+Lin_SwitchISR 										//  Switches from ISR directly come here 
+		LDR		R2, =Lin_NextTask 
+		LDR		R1, [R2] 								//  Get Handle in Lin_NextTask 
+		CMP		R0,  R1 								//  Handles Compared 
+		ITTTT	NE 											//  If not equal- 
+		STRNE	R0, [R2] 								//   put new handle in Lin_NextTask 
+		LDRNE	R1, =0xE000ED00 
+		MOVNE	R0,  #0x10000000 
+		STRNE	R0, [R1, #4] 						//   PendSV Pend Set (SCB->ICSR.28) 
+		BX		LR 											//  Then PendSV executes on demand 
+NotSwitch 												// Not Switch Op 
+		CMP		R0,  #SVCn_LinTrigger		//  Is Trigger Op? 
+		BNE.W	SVC_ProxyCaller 				//   No, go to SVC_ProxyCaller 
+		TST		LR,  #4 								//  Is Trigger Op Enter or Return? 
+		BNE		Return 									//   Trigger Op is Enter 
+		MSR		PSP, R1 								//    Set PSP as current pointer for CtxS 
+		SUB		R2,  R1, #32 
+		MSR		MSP, R2 								//    MSP Stack Growth for CtxS (8 words) 
+		ORR 	LR,  #4 								//    Modify LR to use PSP 
+	IMPORT	Lin_TaskLoader 
+		LDR		R0, =Lin_TaskLoader 
+		LDR		R2, =Lin_CurrTask 
+		STR		R0, [R2] 								//    Set the storing handle to Lin_CurrTask 
+		B			Switch 
+Return 														//   Trigger Op is Return 
+		BIC		LR,  #4 								//    Modify LR, use MSP 
+		LDR		R3, [R1] 								//    Get return value, PensSV didn't use R3 
+		LDR		R1, =Lin_TaskLoader 
+		LDR		R2, =Lin_NextTask  
+		STR		R1, [R2] 								//    Store the storage handle to Lin_NextTask 
+		MOV		R12,  LR 								//    PendSV didn't use R12 
+		BL 		__cpp(PendSV_Handler) 	//    Do CtxSw 
+		MOV		LR,  R12 
+		MRS		R0,  PSP 
+		MSR		MSP, R0 								//    MSP Stack Shrink for CtxS 
+		STR		R3, [R0] 								//    Return value stored in HWStkF 
+		BX		LR 
+	EXPORT	SVC_ProxyCaller		[WEAK] 
+SVC_ProxyCaller 									// If SVC_ProxyCaller not present- 
+		BX		LR 											// Return 
+}
+// Pending Service Handler. 
+// Dedicated for Context Switching. 
+// The 1.0.6 version framework not changed 
+__asm void PendSV_Handler(void){ 
+		// PendSV Handler (Context Switch Performer) 
+		// Disable interrupts will prevent any context switches. 
+	IMPORT	Lin_DebugCtxSwTimes 
+		LDR		R1, =Lin_DebugCtxSwTimes 
+		LDR		R0, [R1] 
+		ADD		R0,  #1 
+		STR		R0, [R1] 
+		NOP 
+	IMPORT	Lin_CurrTask 
+	IMPORT	Lin_NextTask 
+		LDR		R2, =Lin_CurrTask 
+		LDR		R1, =Lin_NextTask 
+		LDR		R0, [R2] 			// CurrTaskHandle in R0 
+		LDR		R1, [R1] 			// NextTaskHandle in R1 
+		STR		R1, [R2] 			// NextTaskHandle stored in _CurrTask 
+		MRS		R2,  PSP 			// A1 Get   PSP1 from Processor 
+		STMDB R2!,{R4-R11} 	// A2 Push  Context {R4-R11} to PSP1  
+		STR		R2, [R0]			// A3 Store PSP1 via CurrTaskHandle->StkPtr 
+		LDR		R2, [R1]			// B1 Get   PSP2 via NextTaskHandle->StkPtr 
+		LDMIA R2!,{R4-R11} 	// B2 Pop   Context {R4-R11} from PSP2 
+		MSR		PSP, R2 			// B3 Set   PSP2 to Processor 
+		BX		LR 						// Pop HW Context {R0-R3,R12,LR,PC,PSR} 
+}
+// End of a section. 
+
+
+// End of file. 
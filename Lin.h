@@ -1,162 +1,226 @@
-// Lin Architecture header file verion 4.0.1 for lyrinka OS 
-#ifndef __Lin_H__ 
-#define __Lin_H__ 
-
-#include <stm32f10x.h> 
-
-/* Comments: 
-	DataStructure of the Memory Carrier Block: 
-		... 				<- High Address 
-		Pld 		- 8 						: Payload Pointer (void *) 
-		Cmd 		- 4 						: Command (u32) 
-		Src 		- 0 <- MSG 			: Source (int) 
-		Next 		- 4 						: Next in queue 
-		... 				<- Low Address 
-
-	DataStructure of the Stack: 
-		... 				<- High Address 
-		StkLim 	-60 						: Stack Bottom 
-		Priority-56 						: Priority. 
-		<many> 	-52 						: TimeSlice related registers. 
-		<many> 	-48 						: Event related registers. 
-		RBN 		-44 						: Pointer RBrN. 
-		LBN 		-40 						: Pointer LBrN. 
-		Next 		-36 						: Pointer Next. 
-		Prev 		-32 						: Pointer Prev. 
-		MsgTail -28 						: Tail fo Message Queue 
-		MsgHead -24 						: Head of Message Queue 
-		MsgQty 	-20 						: Messages waiting in Queue 
-		Counter -16 						: Counter, Initialief as 0xFFFFFFFF 
-		Arg1 		-12 						: Argument 1 
-		Arg0 		- 8 						: Argument 0 
-		Entrance- 4 						: Entrance Point 
-		StkPtr  - 0	<- TASK 		: Stack Pointer 
-		xPSR 		- 4							: Initialized as 0x01000000 (Thumb State) 
-		PC 			- 8 						: ThreadExit Routine(for initialization) 
-		LR 			-12 						: / 
-		Reg12 	-16 						: / 
-		Reg3 		-20 						: (Loop counter value) 
-		Reg2 		-24 						: (Arg1) 
-		Reg1 		-28 						: (Arg0) 
-		Reg0 		-32 <- _HWStkF 	: (reference of itself) 
-		Reg11 	-36 						: / 
-		Reg10 	-40 						: / 
-		Reg9 		-44 						: / 
-		Reg8 		-48 						: / 
-		Reg7 		-52 						: / 
-		Reg6 		-56 						: / 
-		Reg5 		-60 						: / 
-		Reg4 		-64 <- _CtxS 		: / 
-		... 										: Stack Region 
-														: ... 
-														: ... 
-		... 										: Other Region 
-								<- StkBtm 	: Start of the Stack 
-		...					<- Low Address 
-
-	Task Function Params: 
-   void funcTask(TASK Self, u32 Arg0, u32 Arg1, u32 Counter); 
-	 Arg0: user applied argument, default 0 
-	 Arg1: user applied argument, default 0 
-	 Counter: the loop counter, increaced after each ThreadExit routine 
-	 Self: the reference of the Task itself 
-	 The function should not return anything. 
-*/ 
-
-// Configuration
-#define SVCn_LinSwitch 	0x00 
-#define SVCn_LinTrigger	0x01 
-
-#define Lin_MsgPoolSize	32 
-#define Lin_MemStart 	(*((u32 *)0x08000000)) 
-#define Lin_MemEnd 		(Lin_MemStart + 0x5000) 
-
-// Macros 
-#define NULL 			((void *)0) 
-
-#define __critical_alloc() int __IE 
-#define __critical_enter() int __IE = __get_PRIMASK(), __disable_irq() 
-#define __critical_reenter() __IE = __get_PRIMASK(), __disable_irq() 
-#define __critical_exit() __set_PRIMASK(__IE) 
-
-// Types 
-// Inter-Task Message Type - MSG 
-typedef struct Lin_Msg{ 
-	int Src; 
-	u32 Cmd; 
-	void * Pld; 
-}Lin_Msg, MSG; 
-
-// Inter-Task Message Carrier Block Type !!Internal 
-typedef struct Lin_MsgBlk{ 
-	struct Lin_MsgBlk * Next; 
-	Lin_Msg Msg; 
-}Lin_MsgBlk; 
-
-// Event Control Block - For Operating System 
-typedef struct Lin_ECB{ 
-	int TimeBase_Mode; 
-	u32 TimeBase_Stamp; 
-	void * WkupRef; 	// On what Event did it wake up? 
-	int EvListSize; 
-	void * EvList[1]; // Pending improvements. 
-}Lin_ECB; 
-
-// Task Control Block Type - TASK 
-typedef struct Lin_TCB{ 
-	u8 * SP; 
-	void * PC; 
-	int Arg0; 
-	int Arg1; 
-	u32 Cntr; 
-	int MsgQty; // MsgN 
-	Lin_MsgBlk * MsgHead; // MsgF 
-	Lin_MsgBlk * MsgTail; // MsgL 
-
-	struct Lin_TCB * Prev; 
-	struct Lin_TCB * Next; 
-	struct Lin_TCB * LBN; 
-	struct Lin_TCB * RBN; 
-	s8 	WkupSrc; 		// Source of Waking up: EventRef or GenericEvent or TimeBase? 
-	u8 	WkupMeth; 	// Method of Waking up: Is it woke up from previously fired event? 
-	s8 	GenEvFlag; 	// The flag of GenericEvent. A type I Event for waking the process up. 
-	u8 	GenEvInfo; 	// 8-bit data for simple IPC using GE. 
-	s16 TimeSliceCounter; 
-	s16 TimeSliceReload; 
-	int Priority; 
-	Lin_ECB * ECB; 
-}Lin_TCB, * TASK; 
-
-
-// Functions 
-extern	void 		Lin_Init			(void); 													// Initialize Lin Framework 
-
-extern	void * 	Lin_MemAlloc	(u32 Size); 											// Allocate memory 
-extern	void 		Lin_MemFree		(void * Mem); 										// Free memory 
-
-extern	TASK 		Lin_New				(u32 StkSize, void * PC); 				// Create a new Task 
-extern	void 		Lin_SetArgs		(TASK Task, int Arg0, int Arg1); 	// Set Task argumens 
-extern	void 		Lin_SetPC			(TASK Task, void * PC); 					// Set Task entrance point 
-extern	int 		Lin_Enter			(TASK Task); 											// Enter MainTask from main function(MSP) 
-extern	void 		Lin_Switch		(TASK Task); 											// Switch to any other Task 
-extern	void 		Lin_SwitchISR	(TASK Task); 											// Switch to any other Task from ISR 
-extern	void 		Lin_Yield			(void); 													// Switch to MainTask 
-extern	void 		Lin_YieldISR	(void); 													// Switch to MainTask from ISR 
-extern	void 		Lin_Return		(int retval); 										// Return from Task to main function(MSP) 
-extern	void 		Lin_Delete		(TASK Task); 											// Delete Task and free up all the memory 
-
-extern	TASK 		Lin_GetCurrTask(void); 													// Get CurrentTask reference 
-extern	TASK 		Lin_GetMainTask(void); 													// Get MainTask reference 
-
-extern	int 		Lin_MsgPut		(TASK Task, MSG Msg); 						// Send Message to any Task 
-extern	int 		Lin_MsgPutF		(TASK Task, MSG Msg); 						// Sent priority Message to any Task 
-extern	int 		Lin_MsgSubmit	(MSG Msg); 												// Send Message to MainTask 
-extern	int 		Lin_MsgSubmitF(MSG Msg); 												// Send priority Message to MainTask 
-extern	u32 		Lin_MsgQty		(void); 													// Get CurrentTask Message Queue pending 
-extern	MSG 		Lin_MsgGet		(TASK Task); 											// Get Message from ant Task 
-extern	MSG 		Lin_MsgRecv		(void); 													// Get Message from CurrentTask 
-extern	MSG 		Lin_MsgPrvw		(void); 													// Preview Message from CurrentTask 
-
-#endif 
-
-// End of file. 
+// Lin Architecture header file verion 4.8.1 for lyrinka OS 
+#ifndef __Lin_H__ 
+#define __Lin_H__ 
+
+#include <stm32f10x.h> 
+
+/* Comments: 
+	DataStructure of the Memory Carrier Block: 
+		... 				<- High Address 
+		Pld 		- 8 						: Payload Pointer (void *) 
+		Cmd 		- 4 						: Command (u32) 
+		Src 		- 0 <- MSG 			: Source (int) 
+		Next 		- 4 						: Next in queue 
+		... 				<- Low Address 
+
+	DataStructure of the Stack: 
+		... 				<- High Address 
+		StkLim 	-60 						: Stack Bottom 
+		Priority-56 						: Priority. 
+		<many> 	-52 						: TimeSlice related registers. 
+		<many> 	-48 						: Event related registers. 
+		RBN 		-44 						: Pointer RBrN. 
+		LBN 		-40 						: Pointer LBrN. 
+		Next 		-36 						: Pointer Next. 
+		Prev 		-32 						: Pointer Prev. 
+		MsgTail -28 						: Tail fo Message Queue 
+		MsgHead -24 						: Head of Message Queue 
+		MsgQty 	-20 						: Messages waiting in Queue 
+		Counter -16 						: Counter, Initialief as 0xFFFFFFFF 
+		Arg1 		-12 						: Argument 1 
+		Arg0 		- 8 						: Argument 0 
+		Entrance- 4 						: Entrance Point 
+		StkPtr  - 0	<- TASK 		: Stack Pointer 
+		xPSR 		- 4							: Initialized as 0x01000000 (Thumb State) 
+		PC 			- 8 						: ThreadExit Routine(for initialization) 
+		LR 			-12 						: / 
+		Reg12 	-16 						: / 
+		Reg3 		-20 						: (Loop counter value) 
+		Reg2 		-24 						: (Arg1) 
+		Reg1 		-28 						: (Arg0) 
+		Reg0 		-32 <- _HWStkF 	: (reference of itself) 
+		Reg11 	-36 						: / 
+		Reg10 	-40 						: / 
+		Reg9 		-44 						: / 
+		Reg8 		-48 						: / 
+		Reg7 		-52 						: / 
+		Reg6 		-56 						: / 
+		Reg5 		-60 						: / 
+		Reg4 		-64 <- _CtxS 		: / 
+		... 										: Stack Region 
+														: ... 
+														: ... 
+		... 										: Other Region 
+								<- StkBtm 	: Start of the Stack 
+		...					<- Low Address 
+
+	Task Function Params: 
+   void funcTask(TASK Self, u32 Arg0, u32 Arg1, u32 Counter); 
+	 Arg0: user applied argument, default 0 
+	 Arg1: user applied argument, default 0 
+	 Counter: the loop counter, increaced after each ThreadExit routine 
+	 Self: the reference of the Task itself 
+	 The function should not return anything. 
+*/ 
+
+// Configuration
+#define SVCn_LinSwitch 	0x00 
+#define SVCn_LinTrigger	0x01 
+
+#define Lin_MsgPoolSize	32 
+#define Lin_EvListMax 	4 						// Capacity of the Event List in each ECB 
+#define Lin_MsgLanes 	4 						// Message priority lanes, lane 0 is the TCB queue, up to 32 
+#define Lin_StkPaint 	1 						// Paint new stacks for high-water tracking, 0 to skip 
+#define Lin_StkMagic 	0xCCCCCCCC 		// Paint pattern 
+#define Lin_RecyBins 	4 						// Stack sizes kept for recycling deleted Tasks 
+#define Lin_RecyDepth 	4 						// Stack blocks kept per size 
+#define Lin_MemStart 	(*((u32 *)0x08000000)) 
+#define Lin_MemEnd 		(Lin_MemStart + 0x5000) 
+
+// Macros 
+#define NULL 			((void *)0) 
+
+#define __critical_alloc() int __IE 
+#ifndef Lin_CsProf 
+#define __critical_enter() int __IE = __get_PRIMASK(), __disable_irq() 
+#define __critical_reenter() __IE = __get_PRIMASK(), __disable_irq() 
+#define __critical_exit() __set_PRIMASK(__IE) 
+#else 	// Profiled critical regions, see Lin_CsEnter. 
+#define __critical_enter() int __IE = Lin_CsEnter((void *)__current_pc(), (void *)__return_address()) 
+#define __critical_reenter() __IE = Lin_CsEnter((void *)__current_pc(), (void *)__return_address()) 
+#define __critical_exit() Lin_CsExit(__IE) 
+#endif 
+
+#define Lin_CycCnt() 	(*((volatile u32 *)0xE0001004)) 	// DWT Cycle Counter, started by Lin_Init 
+
+// Kernel metrics, see Met. Updates are atomic, and compiled out with Met_Enable 0. 
+#define Met_Enable 	1 
+#if Met_Enable 
+#define Met_Add(var, n) do{ u32 __Met; do __Met = __ldrex(&(var)) + (n); while(__strex(__Met, &(var))); }while(0) 
+#else 
+#define Met_Add(var, n) do{}while(0) 
+#endif 
+#define Met_Inc(var) Met_Add(var, 1) 
+#define Met_Dec(var) Met_Add(var, -1) 
+
+// Critical Region Profiler Record, build with Lin_CsProf defined to collect them 
+#define Lin_CsTop 	8 		// Longest masked regions kept, per core 
+typedef struct Lin_CsRec{ 
+	void * Site; 		// Where the region was entered 
+	void * Caller; 	// Return address of the function entering it 
+	u32 Max; 				// Longest masked interval in cycles 
+	u32 Hits; 			// Times it made the table 
+}Lin_CsRec; 
+
+// Types 
+// Inter-Task Message Type - MSG 
+typedef struct Lin_Msg{ 
+	int Src; 
+	u32 Cmd; 
+	void * Pld; 
+}Lin_Msg, MSG; 
+
+// Inter-Task Message Carrier Block Type !!Internal 
+typedef struct Lin_MsgBlk{ 
+	struct Lin_MsgBlk * Next; 
+	Lin_Msg Msg; 
+}Lin_MsgBlk; 
+
+// Event Control Block - For Operating System 
+typedef struct Lin_ECB{ 
+	int TimeBase_Mode; 		// < 0 off, 0 one-shot, > 0 period in us 
+	u32 TimeBase_Stamp; 	// Next release in us, low 32 bits of OS_TimeUs 
+	void * WkupRef; 	// On what Event did it wake up? 
+	int EvListSize; 
+	int MsgCap; 									// Mailbox capacity, 0 for unbounded. 
+	int TxWaiting; 								// Blocked on a full mailbox? 1 parked, 2 woken but still queued. 
+	struct Lin_TCB * TxOn; 				// Task whose mailbox it is queued on, NULL once that task is deleted. 
+	struct Lin_TCB * TxNext; 			// Next sender blocked on the same mailbox. 
+	struct Lin_TCB * TxWaitHead; 	// Senders blocked on this mailbox. 
+	struct Lin_TCB * TxWaitTail; 
+	void * Hist; 									// Release histogram, see Sched. 
+	void * CallHead; 							// Calls queued on this server, see OS_Call. 
+	void * CallTail; 
+	void * CallTaken; 						// Calls accepted and not yet answered. 
+	void * CallBlk; 							// Call of this client being served. 
+	int CallWait; 								// Server blocked in OS_Accept? 
+	int CallDonated; 							// Priority raised by callers? 
+	int CallBase; 								// Priority before the donation. 
+	u32 MsgLaneMap; 							// Bit n set while lane n > 0 holds Messages. 
+	struct Lin_MsgBlk * MsgLaneHead[Lin_MsgLanes - 1]; 	// Lanes 1 and up, lane 0 is MsgHead of the TCB. 
+	struct Lin_MsgBlk * MsgLaneTail[Lin_MsgLanes - 1]; 
+	void * EvList[Lin_EvListMax]; // ECB sits at the stack bottom, so a longer list only costs stack. 
+}Lin_ECB; 
+
+// Task Control Block Type - TASK 
+typedef struct Lin_TCB{ 
+	u8 * SP; 
+	void * PC; 
+	int Arg0; 
+	int Arg1; 
+	u32 Cntr; 
+	int MsgQty; // MsgN 
+	Lin_MsgBlk * MsgHead; // MsgF 
+	Lin_MsgBlk * MsgTail; // MsgL 
+
+	struct Lin_TCB * Prev; 
+	struct Lin_TCB * Next; 
+	struct Lin_TCB * LBN; 
+	struct Lin_TCB * RBN; 
+	s8 	WkupSrc; 		// Source of Waking up: EventRef or GenericEvent or TimeBase? 
+	u8 	WkupMeth; 	// Method of Waking up: Is it woke up from previously fired event? 
+	s8 	GenEvFlag; 	// The flag of GenericEvent. A type I Event for waking the process up. 
+	u8 	GenEvInfo; 	// 8-bit data for simple IPC using GE. 
+	s16 TimeSliceCounter; 
+	s16 TimeSliceReload; 
+	int Priority; 
+	Lin_ECB * ECB; 
+}Lin_TCB, * TASK; 
+
+
+// Functions 
+extern	void 		Lin_Init			(void); 													// Initialize Lin Framework 
+
+extern	void * 	Lin_MemAlloc	(u32 Size); 											// Allocate memory 
+extern	void 		Lin_MemFree		(void * Mem); 										// Free memory 
+
+extern	TASK 		Lin_New				(u32 StkSize, void * PC); 				// Create a new Task 
+extern	void 		Lin_SetArgs		(TASK Task, int Arg0, int Arg1); 	// Set Task argumens 
+extern	void 		Lin_SetPC			(TASK Task, void * PC); 					// Set Task entrance point 
+extern	int 		Lin_Enter			(TASK Task); 											// Enter MainTask from main function(MSP) 
+extern	void 		Lin_Switch		(TASK Task); 											// Switch to any other Task 
+extern	void 		Lin_SwitchISR	(TASK Task); 											// Switch to any other Task from ISR 
+extern	void 		Lin_Yield			(void); 													// Switch to MainTask 
+extern	void 		Lin_YieldISR	(void); 													// Switch to MainTask from ISR 
+extern	void 		Lin_Return		(int retval); 										// Return from Task to main function(MSP) 
+extern	void 		Lin_Delete		(TASK Task); 											// Delete Task and free up all the memory 
+
+extern	TASK 		Lin_GetCurrTask(void); 													// Get CurrentTask reference 
+extern	TASK 		Lin_GetMainTask(void); 													// Get MainTask reference 
+extern	u32 		Lin_StkSize		(TASK Task); 											// Get Stack size of a Task 
+extern	u32 		Lin_StkFree		(TASK Task); 											// Get Stack never touched by a Task 
+
+extern	int 		Lin_MsgPut		(TASK Task, MSG Msg); 						// Send Message to any Task 
+extern	int 		Lin_MsgPutF		(TASK Task, MSG Msg); 						// Sent priority Message to any Task 
+extern	int 		Lin_MsgPutN		(TASK Task, const MSG * Msg, u32 N); // Send N Messages to any Task at once 
+extern	int 		Lin_MsgPutL		(TASK Task, MSG Msg, int Lane); 	// Send Message to any Task in a priority lane 
+extern	int 		Lin_MsgDrop		(TASK Task, MSG * Msg); 							// Drop the oldest Message of the lowest lane 
+extern	u32 		Lin_MsgSplice	(TASK Dst, TASK Src); 						// Move whole Message Queue between Tasks 
+extern	int 		Lin_MsgSubmit	(MSG Msg); 												// Send Message to MainTask 
+extern	int 		Lin_MsgSubmitF(MSG Msg); 												// Send priority Message to MainTask 
+extern	u32 		Lin_MsgQty		(void); 													// Get CurrentTask Message Queue pending 
+extern	MSG 		Lin_MsgGet		(TASK Task); 											// Get Message from ant Task 
+extern	MSG 		Lin_MsgRecv		(void); 													// Get Message from CurrentTask 
+extern	u32 		Lin_MsgRecvN	(MSG * Msg, u32 Max); 						// Get up to Max Messages from CurrentTask 
+extern	MSG 		Lin_MsgPrvw		(void); 													// Preview Message from CurrentTask 
+
+#ifdef Lin_CsProf 
+extern	u32 		Lin_CsEnter		(void * Site, void * Caller); 		// Mask interrupts and stamp the outermost region 
+extern	void 		Lin_CsExit		(u32 IE); 												// Record the region and restore the mask 
+extern	int 		Lin_CsReport	(Lin_CsRec * Rec, int Max); 			// Copy the longest regions of all cores, longest first 
+extern	void 		Lin_CsReset		(void); 													// Clear the tables 
+#endif 
+
+#endif 
+
+// End of file. 
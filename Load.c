@@ -0,0 +1,88 @@
+// CPU Load Monitor version 0.1.1 
+/* Release Notes: 
+
+		<0.1.1 > 261019 Roll computes in 64 bits, seconds stretched past 59 s at 72 MHz no longer overflow. 
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	The scheduler task brackets every pass with Load_Enter and Load_Leave. 
+	The cycles between a Leave and the next Enter belong to the task switched to, 
+	the cycles between an Enter and its Leave to the scheduler itself. 
+	Cycles of the idle task are not counted at all: once per second the busy cycles 
+	are set against the wall clock, so an idle task sleeping in __WFI under LPW, 
+	where the cycle counter may stop, still reads as idle. 
+	Figures are in permille. The 10 s and 60 s windows are exponential averages. 
+*/
+#include <OS.h> 
+
+TASK Load_Idle; 				// The idle task 
+TASK Load_Prev; 				// Task switched to by the last pass 
+u32  Load_Stamp; 				// Cycle Counter at the last Enter or Leave 
+u32  Load_SecStart; 			// TickCount at the start of the current second 
+u32  Load_Cyc[Load_Bands]; 	// Busy cycles in the current second 
+int  Load_BandPm[Load_Bands]; 	// Utilization per band in the last second 
+int  Load_Avg[3]; 				// Load averages, permille * 16 
+
+void Load_Init(TASK Idle){ 
+	Load_Idle = Idle; 
+	Load_Prev = NULL; 
+	Load_Stamp = Lin_CycCnt(); 
+	Load_SecStart = TickCount; 
+	for(int i = 0; i < Load_Bands; i++){ 
+		Load_Cyc[i] = 0; 
+		Load_BandPm[i] = 0; 
+	}
+	for(int i = 0; i < 3; i++) Load_Avg[i] = 0; 
+}
+
+void Load_Roll(u32 Ms){ 	// Close a second worth Ms of wall clock. 
+	unsigned long long Wall = (unsigned long long)Ms * (SystemCoreClock / 1000); 
+	unsigned long long Busy = 0; 
+	for(int i = 0; i < Load_Bands; i++){ 
+		Busy += Load_Cyc[i]; 
+		Load_BandPm[i] = (int)(((unsigned long long)Load_Cyc[i] * 1000) / Wall); 
+		Load_Cyc[i] = 0; 
+	}
+	int Pm = (int)((Busy * 1000) / Wall); 
+	if(Pm > 1000) Pm = 1000; 
+	Load_Avg[Load_1s] = Pm * 16; 
+	Load_Avg[Load_10s] += (Pm * 16 - Load_Avg[Load_10s]) / 10; 
+	Load_Avg[Load_60s] += (Pm * 16 - Load_Avg[Load_60s]) / 60; 
+}
+
+void Load_Enter(void){ 	// Scheduler resumed: charge the interval to the task that ran. 
+	u32 Now = Lin_CycCnt(); 
+	TASK Task = Load_Prev; 
+	if(Task != NULL && Task != Load_Idle){ 
+		int Band; 
+		if(Task->Priority < 0) Band = Load_BandHigh; 
+		else if(Task->Priority == 0) Band = Load_BandNorm; 
+		else Band = Load_BandLow; 
+		Load_Cyc[Band] += Now - Load_Stamp; 
+	}
+	Load_Stamp = Now; 
+}
+
+void Load_Leave(TASK Next){ 	// Scheduler about to switch: charge the pass to the kernel. 
+	u32 Now = Lin_CycCnt(); 
+	Load_Cyc[Load_BandKern] += Now - Load_Stamp; 
+	Load_Stamp = Now; 
+	Load_Prev = Next; 
+	u32 Ms = TickCount - Load_SecStart; 
+	if(Ms >= 1000){ 
+		Load_SecStart = TickCount; 
+		Load_Roll(Ms); 
+	}
+}
+
+int Load_Get(int Window){ 	// CPU load in permille over a window. 
+	if(Window < 0 || Window > 2) return -1; 
+	return Load_Avg[Window] / 16; 
+}
+
+int Load_Band(int Band){ 	// Share of one priority band in the last second, permille. 
+	if(Band < 0 || Band >= Load_Bands) return -1; 
+	return Load_BandPm[Band]; 
+}
+
+// End of file. 
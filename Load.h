@@ -0,0 +1,26 @@
+// CPU Load Monitor version 0.1.1 header file 
+#ifndef __Load_H__ 
+#define __Load_H__ 
+
+// Priority Bands 
+#define Load_BandHigh 	0 	// Priority < 0 
+#define Load_BandNorm 	1 	// Priority == 0 
+#define Load_BandLow 	2 	// Priority > 0, except the idle task 
+#define Load_BandKern 	3 	// The scheduler itself 
+#define Load_Bands 		4 
+
+// Load Average Windows 
+#define Load_1s 	0 
+#define Load_10s 	1 
+#define Load_60s 	2 
+
+void Load_Init(TASK Idle); 
+void Load_Enter(void); 
+void Load_Leave(TASK Next); 
+
+int  Load_Get(int Window); 
+int  Load_Band(int Band); 
+
+#endif 
+
+// End of file. 
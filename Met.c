@@ -0,0 +1,245 @@
+// Kernel Metrics Registry version 0.1.2 
+/* Release Notes: 
+
+		<0.1.2 > 261019 One scheduler context again, Sched.Steals is gone. 
+		<0.1.1 > 261019 Task fields are copied while the task lists are held, a deleted task is never read. 
+										At most Met_FieldMax fields. 
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	The kernel debug counters are registered here under a name, together with 
+	any counter or gauge an application adds through Met_Reg, and fields of the TCB 
+	that are exported for every task. Counters themselves stay where they are and are 
+	updated with Met_Inc / Met_Add from Lin.h, which are atomic and vanish with Met_Enable 0. 
+
+	An exporter task started by Met_Init wakes every Period ms and writes binary frames: 
+		A5 5A Type Len(varint) Payload Sum 
+	Sum is the low byte of the payload sum. Varints are LEB128, deltas are zigzagged. 
+		Dict 	(Id, Kind, Name, 0)... 
+		Delta 	Stamp(ms), (Id, Value)... 	only metrics that changed, counters as deltas 
+		Task 	Task(address), (Id, Value)... 	one frame per task 
+	The dictionary goes out first and again every Met_DictEvery rounds. 
+	tools/metdec.c decodes the stream on the host, e.g. from QEMU started with 
+	-semihosting and Met_Out set to Met_OutSemi, or from an SWO capture of the ITM port. 
+*/
+#include <OS.h> 
+#include <Lint.h> 
+#include <stddef.h> 
+
+#if Met_Enable 
+
+extern int Lin_DebugMemLeak; 
+extern u32 Lin_DebugMemAllocTimes; 
+extern u32 Lin_DebugMsgOpTimes; 
+extern u32 Lin_DebugCtxSwTimes; 
+extern int Lint_DebugOpTimes; 
+extern u32 Sched_DebugSchedTimes; 
+extern u32 Sched_DebugTickSkips; 
+extern int Event_DebugEventQurtyCnt; 
+extern int Event_DebugEvCycleStamp; 
+
+Met_Blk Met_List[Met_Max]; 
+int  Met_Count; 
+u32  Met_Period; 		// Export period in ms 
+u32  Met_Round; 		// Exports so far 
+TASK Met_TaskRef; 		// The exporter task 
+u8   Met_Buf[Met_BufSize]; 
+TASK Met_SnapTask[Met_TaskMax]; 	// Tasks and their fields of this round 
+s32  Met_SnapVal[Met_TaskMax][Met_FieldMax]; 
+u8   Met_FieldId[Met_FieldMax]; 	// Ids of the field metrics 
+int  Met_FieldCnt; 
+int  Met_Len; 
+int  Met_Handle = -1; 	// Semihosting file handle 
+
+void Met_Task(TASK Self); 
+
+int Met_Reg(const char * Name, int Kind, volatile void * Ref){ 	// Register a counter or gauge. Returns its id, or -1 when full. 
+	if(Kind == Met_Field) return -1; 
+	__critical_enter(); 
+	int Id = Met_Count; 
+	if(Id >= Met_Max){ 
+		__critical_exit(); 
+		return -1; 
+	}
+	Met_List[Id].Name = Name; 
+	Met_List[Id].Kind = Kind; 
+	Met_List[Id].Ref = (volatile u32 *)Ref; 
+	Met_List[Id].Offset = 0; 
+	Met_List[Id].Last = *(volatile u32 *)Ref; 
+	Met_Count = Id + 1; 
+	__critical_exit(); 
+	return Id; 
+}
+
+int Met_RegField(const char * Name, u32 Offset){ 	// Register a word of the TCB, exported per task. 
+	__critical_enter(); 
+	int Id = Met_Count; 
+	if(Id >= Met_Max || Met_FieldCnt >= Met_FieldMax || (Offset & 3) != 0 || Offset >= sizeof(Lin_TCB)){ 
+		__critical_exit(); 
+		return -1; 
+	}
+	Met_List[Id].Name = Name; 
+	Met_List[Id].Kind = Met_Field; 
+	Met_List[Id].Ref = NULL; 
+	Met_List[Id].Offset = Offset; 
+	Met_List[Id].Last = 0; 
+	Met_FieldId[Met_FieldCnt++] = Id; 
+	Met_Count = Id + 1; 
+	__critical_exit(); 
+	return Id; 
+}
+
+TASK Met_Init(u32 Period){ 	// Register the kernel metrics and start the exporter. 
+	Met_Count = 0; 
+	Met_FieldCnt = 0; 
+	Met_Round = 0; 
+	Met_Period = Period > 0 ? Period : 1; 
+	Met_Reg("Lin.MemLeak", Met_Gauge, &Lin_DebugMemLeak); 
+	Met_Reg("Lin.MemAlloc", Met_Counter, &Lin_DebugMemAllocTimes); 
+	Met_Reg("Lin.MsgOps", Met_Counter, &Lin_DebugMsgOpTimes); 
+	Met_Reg("Lin.CtxSw", Met_Counter, &Lin_DebugCtxSwTimes); 
+	Met_Reg("Lint.Ops", Met_Counter, &Lint_DebugOpTimes); 
+	Met_Reg("Sched.Passes", Met_Counter, &Sched_DebugSchedTimes); 
+	Met_Reg("Ev.Queries", Met_Counter, &Event_DebugEventQurtyCnt); 
+	Met_Reg("Ev.Cycles", Met_Counter, &Event_DebugEvCycleStamp); 
+	Met_Reg("Sched.TickSkips", Met_Counter, &Sched_DebugTickSkips); 
+	Met_RegField("Task.Priority", offsetof(Lin_TCB, Priority)); 
+	Met_RegField("Task.MsgQty", offsetof(Lin_TCB, MsgQty)); 
+	Met_TaskRef = OS_New(Met_StkSize, Met_Task); 
+	if(Met_TaskRef == NULL) return NULL; 
+	Met_TaskRef->Priority = Met_TaskPri; 
+	OS_GenEvent(Met_TaskRef, 0); 
+	return Met_TaskRef; 
+}
+
+// Output 
+void Met_Write(const u8 * Data, int Len){ 
+#if Met_Out == Met_OutItm 
+	volatile u32 * TCR = (volatile u32 *)0xE0000E80; 
+	volatile u32 * TER = (volatile u32 *)0xE0000E00; 
+	volatile u32 * Port = (volatile u32 *)(0xE0000000 + 4 * Met_ItmPort); 
+	if((*TCR & 1) == 0 || (*TER & (1u << Met_ItmPort)) == 0) return; 	// No trace attached, drop the frame. 
+	for(int i = 0; i < Len; i++){ 
+		while((*Port & 1) == 0); 
+		*(volatile u8 *)Port = Data[i]; 
+	}
+#else 
+	if(Met_Handle < 0){ 
+		u32 Open[3] = {(u32)Met_SemiFile, 5, sizeof(Met_SemiFile) - 1}; 	// Mode 5 is "wb". 
+		Met_Handle = __semihost(0x01, Open); 
+		if(Met_Handle < 0) return; 
+	}
+	u32 Write[3] = {(u32)Met_Handle, (u32)Data, (u32)Len}; 
+	__semihost(0x05, Write); 
+#endif 
+}
+
+// Frame building, on Met_Buf 
+void Met_Begin(int Type){ 
+	Met_Buf[0] = Type; 
+	Met_Len = 1; 
+}
+
+int Met_Room(int Need){ 
+	return Met_Len + Need <= Met_BufSize - 8; 	// Header and Sum. 
+}
+
+void Met_Byte(u8 Data){ 
+	Met_Buf[Met_Len++] = Data; 
+}
+
+void Met_Var(u32 Value){ 	// LEB128, at most 5 bytes. 
+	while(Value >= 0x80){ 
+		Met_Byte((u8)(Value | 0x80)); 
+		Value >>= 7; 
+	}
+	Met_Byte((u8)Value); 
+}
+
+void Met_Zig(s32 Value){ 
+	Met_Var(((u32)Value << 1) ^ (u32)(Value >> 31)); 
+}
+
+void Met_End(void){ 	// Prefix sync and length, append the sum and write it out. 
+	u8 Head[8]; 
+	int N = 0; 
+	u32 Len = Met_Len - 1; 
+	u8 Sum = 0; 
+	for(int i = 1; i < Met_Len; i++) Sum += Met_Buf[i]; 
+	Head[N++] = Met_Sync0; 
+	Head[N++] = Met_Sync1; 
+	Head[N++] = Met_Buf[0]; 
+	while(Len >= 0x80){ 
+		Head[N++] = (u8)(Len | 0x80); 
+		Len >>= 7; 
+	}
+	Head[N++] = (u8)Len; 
+	Met_Write(Head, N); 
+	Met_Buf[Met_Len++] = Sum; 
+	Met_Write(Met_Buf + 1, Met_Len - 1); 
+}
+
+void Met_Dict(void){ 
+	Met_Begin(Met_FrmDict); 
+	for(int Id = 0; Id < Met_Count; Id++){ 
+		const char * Name = Met_List[Id].Name; 
+		int Len = 0; 
+		while(Name[Len] != 0) Len++; 
+		if(!Met_Room(Len + 3)){ 
+			Met_End(); 
+			Met_Begin(Met_FrmDict); 
+		}
+		Met_Byte(Id); 
+		Met_Byte(Met_List[Id].Kind); 
+		for(int i = 0; i <= Len; i++) Met_Byte(Name[i]); 
+	}
+	Met_End(); 
+}
+
+void Met_Export(void){ 	// One round: dictionary if due, then deltas and per task fields. 
+	if(Met_Round++ % Met_DictEvery == 0) Met_Dict(); 
+	Met_Begin(Met_FrmDelta); 
+	Met_Var(TickCount); 
+	for(int Id = 0; Id < Met_Count; Id++){ 
+		Met_Blk * Met = &Met_List[Id]; 
+		if(Met->Kind == Met_Field) continue; 
+		u32 Value = *Met->Ref; 
+		if(Value == Met->Last) continue; 
+		if(!Met_Room(6)) break; 	// The rest goes out next round. 
+		Met_Byte(Id); 
+		if(Met->Kind == Met_Counter) Met_Zig((s32)(Value - Met->Last)); 
+		else Met_Zig((s32)Value); 
+		Met->Last = Value; 
+	}
+	Met_End(); 
+	int N = 0; 
+	__critical_enter(); 	// Copy the fields while the lists are held, a deleted task may be freed right after. 
+	for(TASK T = PQ_Trav(NULL); T != NULL && N < Met_TaskMax; T = PQ_Trav(T)) Met_SnapTask[N++] = T; 
+	for(TASK T = DL_Trav(NULL); T != NULL && N < Met_TaskMax; T = DL_Trav(T)) Met_SnapTask[N++] = T; 
+	for(int i = 0; i < N; i++) 
+		for(int f = 0; f < Met_FieldCnt; f++) 
+			Met_SnapVal[i][f] = *(volatile s32 *)((u8 *)Met_SnapTask[i] + Met_List[Met_FieldId[f]].Offset); 
+	__critical_exit(); 
+	for(int i = 0; i < N; i++){ 	// The address only names the task from here on. 
+		Met_Begin(Met_FrmTask); 
+		Met_Var((u32)Met_SnapTask[i]); 
+		for(int f = 0; f < Met_FieldCnt; f++){ 
+			if(!Met_Room(6)) break; 
+			Met_Byte(Met_FieldId[f]); 
+			Met_Zig(Met_SnapVal[i][f]); 
+		}
+		Met_End(); 
+	}
+}
+
+void Met_Task(TASK Self){ 	// Exporter task. 
+	OS_TBGperiod(Met_Period); 
+	for(;;){ 
+		Met_Export(); 
+		OS_Suspend(); 
+	}
+}
+
+#endif 
+
+// End of file. 
@@ -0,0 +1,51 @@
+// Kernel Metrics Registry version 0.1.2 header file 
+#ifndef __Met_H__ 
+#define __Met_H__ 
+
+// Configuration, Met_Enable and the update macros live in Lin.h 
+#define Met_Max 		32 		// Metrics in the registry 
+#define Met_TaskMax 	16 		// Tasks exported per round 
+#define Met_FieldMax 	4 		// TCB fields in the registry 
+#define Met_StkSize 	512 	// Stack of the exporter task 
+#define Met_TaskPri 	16 		// Priority of the exporter task, below default tasks 
+#define Met_DictEvery 	16 		// Rounds between dictionary frames, lets a late host catch up 
+#define Met_BufSize 	256 	// Largest frame 
+
+// Output Channels 
+#define Met_OutItm 		0 		// ITM stimulus port Met_ItmPort, needs a debugger with SWO 
+#define Met_OutSemi 	1 		// Semihosting SYS_WRITE to Met_SemiFile, halts the core per frame 
+#ifndef Met_Out 
+#define Met_Out 		Met_OutItm 
+#endif 
+#define Met_ItmPort 	1 
+#define Met_SemiFile 	"met.bin" 
+
+// Metric Kinds 
+#define Met_Counter 	0 		// Monotonic u32, exported as a delta 
+#define Met_Gauge 		1 		// Level, exported as is 
+#define Met_Field 		2 		// s32 at a byte offset in every TCB, exported per task 
+
+// Frame Types 
+#define Met_Sync0 		0xA5 
+#define Met_Sync1 		0x5A 
+#define Met_FrmDict 	1 
+#define Met_FrmDelta 	2 
+#define Met_FrmTask 	3 
+
+// Metric Block !!Internal 
+typedef struct Met_Blk{ 
+	const char * Name; 
+	int Kind; 
+	volatile u32 * Ref; 	// Counter or gauge 
+	u32 Offset; 			// TCB field 
+	u32 Last; 				// Value at the last export 
+}Met_Blk; 
+
+int  Met_Reg(const char * Name, int Kind, volatile void * Ref); 
+int  Met_RegField(const char * Name, u32 Offset); 
+TASK Met_Init(u32 Period); 
+void Met_Export(void); 
+
+#endif 
+
+// End of file. 
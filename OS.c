@@ -1,109 +1,623 @@
-// lyrinka OS version 1.0.2 
-/* Release Notes: 
-
-		<1.0.2 > 190301 Header file added extern "C" to work with c++. 
-		<1.0.1 > 190301 TaskDecl macro deprecated. 
-		<1.0.0 > 190228 No changes. 
-		<0.2.1 > 190226 Added PreemptISR macro replacing the old Lin_YieldISR system call for readability. 
-		<0.2.0 > 190208 Added Yield and Preempt functions. 
-		<0.1.1 > 190206 Added support for dynamic priorities. 
-		<0.1.0 > 190203 Initial Release. This is a library for simplified programming. 
-*/ 
-#include <OS.h> 
-#include <Lint.h> 
-
-TASK OS_New(u32 StkSize, void * PC){ 
-	TASK Task = Lin_New(StkSize, PC); 
-	if(Task == NULL) return NULL; 
-	Task->WkupSrc = Src_None; 
-	Task->WkupMeth = Meth_None; 
-	Task->GenEvFlag = 0; 
-	Task->GenEvInfo = 0; 
-	Task->TimeSliceCounter = 10; 
-	Task->TimeSliceReload = 10; 
-	Task->Priority = 0; 
-	Lin_ECB * ECB = Task->ECB; 
-	ECB->TimeBase_Mode = -1; 
-	ECB->TimeBase_Stamp = 0; 
-	ECB->WkupRef = NULL; 
-	ECB->EvListSize = 0; 
-	Sched_Reg(Task); 
-	return Task; 
-}
-
-void OS_ChgPri(TASK Task, int Priority){ 
-	if(Task == NULL) Task = Lin_GetCurrTask(); 
-	if(Lint_IsDead(Task)) return; 
-	__critical_enter(); 
-	if(Lint_IsNotWaiting(Task)) Task->Priority = Priority; 
-	else{ 
-		PQ_Del(Task); 
-		Task->Priority = Priority; 
-		PQ_Add(Task); 
-	}
-	__critical_exit(); 
-}
-
-void OS_Del(TASK Task){ 
-	int self = 0; 
-	if(Task == NULL){ 
-		self = 1; 
-		Task = Lin_GetCurrTask(); 
-	}
-	__critical_enter(); 
-	Sched_UnReg(Task); 
-	Lin_Delete(Task); 
-	__critical_exit(); 
-	if(self != 0) OS_Suspend(); 
-}
-
-void OS_GenEvent(TASK Task, u8 info){ 
-	__critical_enter(); 
-	Task->GenEvInfo = info; 
-	Task->GenEvFlag = 1; 
-	__critical_exit(); 
-}
-
-void OS_TBGperiod(int interval){ 
-	__critical_enter(); 
-	Lin_ECB * ECB = Lin_GetCurrTask()->ECB; 
-	ECB->TimeBase_Mode = interval; 
-	ECB->TimeBase_Stamp = TickCount + interval; 
-	__critical_exit();  
-}
-
-void OS_TBGdelay(int time){ 
-	__critical_enter(); 
-	Lin_ECB * ECB = Lin_GetCurrTask()->ECB; 
-	ECB->TimeBase_Mode = 0; 
-	ECB->TimeBase_Stamp = TickCount + time; 
-	__critical_exit(); 
-}
-
-void OS_TBGstop(void){ 
-	__critical_enter(); 
-	Lin_ECB * ECB = Lin_GetCurrTask()->ECB; 
-	ECB->TimeBase_Mode = -1; 
-	ECB->TimeBase_Stamp = 0; 
-	__critical_exit(); 
-}
-
-void OS_Yield(void){ 
-	MSG Msg; 
-	Msg.Cmd = 0x1; 
-	Msg.Src = 0x0; 
-	Msg.Pld = Lin_GetCurrTask(); 
-	Lin_MsgSubmit(Msg); 
-	Lin_Yield(); 
-}
-
-void OS_Suspend(void){ 
-	MSG Msg; 
-	Msg.Cmd = 0x0; 
-	Msg.Src = 0x0; 
-	Msg.Pld = Lin_GetCurrTask(); 
-	Lin_MsgSubmit(Msg); 
-	Lin_Yield(); 
-}
-
-// End of file. 
+// lyrinka OS version 1.12.1 
+/* Release Notes: 
+
+		<1.12.1> 261019 WaitAny and WaitAll latch the epoch they arm in and ignore broadcasts latched no later than that. 
+		<1.12.0> 261019 Removed SetAffinity with the multi-core scheduler. StkReport walks the single pair of lists again. 
+		<1.11.1> 261019 Del removes the task from every topic and passes the Messages left in its mailbox to the drop path. 
+		<1.11.0> 261019 TxMsgN and MvMsg are functions honouring MsgCap like TxMsg. MvMsg lets senders blocked on the source in. 
+		<1.10.6> 261019 Messages dropped by Tx_Over release their Topic payload or go to the hook set by DropHook. 
+		<1.10.5> 261019 WaitAny and WaitAll reject oversized sets with OS_WaitErr and clamp Timeout to OS_TBGMaxMs. 
+										WaitAny keeps waiting on a wake-up by a foreign event. A one-shot TBG overtaken by the wait is dropped. 
+		<1.10.4> 261019 Del cancels the call of a deleted client and fails the pending calls of a deleted server. 
+										Accepted calls keep their donation until answered. 
+		<1.10.3> 261019 Del takes the task off the mailbox it is blocked on and fails the senders blocked on its own. 
+		<1.10.2> 261019 TBGperiod and TBGdelay clamp to OS_TBGMaxMs instead of overflowing. 
+		<1.10.1> 261019 OS.h now includes the Seq library. 
+		<1.10.0> 261019 Added TxMsgL for priority lanes. The overwrite mode drops from the lowest lane. 
+		<1.9.0 > 261019 Added Call, Accept and Reply: synchronous calls with priority donation and direct switches. 
+		<1.8.0 > 261019 OS.h now includes the Met metrics registry. 
+		<1.7.2 > 261019 Added HistAttach, HistReset and HistPct macros for release histograms. 
+		<1.7.1 > 261019 OS.h declares the simulation hooks of the SIM option. 
+		<1.7.0 > 261019 Added SetAffinity. New tasks start on the creating core. StkReport covers every core. 
+		<1.6.0 > 261019 GenEvent, ChgPri and message sends request a scheduling pass from the tick ISR. 
+		<1.5.1 > 261019 OS.h now includes the Stream library. 
+		<1.5.0 > 261019 OS.h now includes the Pool library. Added PoolCreate, PoolAlloc and PoolFree macros. 
+		<1.4.0 > 261019 Added StkReport with stack high-water marks and suggested sizes. 
+		<1.3.1 > 261019 OS.h now includes the Load library. 
+		<1.3.0 > 261019 TBG runs on the microsecond timebase. Added TBGperiodUs and TBGdelayUs. 
+		<1.2.1 > 261019 OS.h now includes the Timer library. 
+		<1.2.0 > 261019 Added WaitAny and WaitAll: event wait sets with timeout in a single call. 
+		<1.1.1 > 261019 Added EvWait for blocking on event objects. 
+		<1.1.0 > 261019 Added bounded mailboxes. TxMsg honours the capacity set by MsgCap, TxMsgEx adds overwrite and blocking modes. 
+										RxMsg is now a function letting blocked senders in. 
+		<1.0.4 > 261019 OS.h now includes the Topic library. 
+		<1.0.3 > 261019 Added batched messaging macros TxMsgN, RxMsgN and MvMsg. 
+		<1.0.2 > 190301 Header file added extern "C" to work with c++. 
+		<1.0.1 > 190301 TaskDecl macro deprecated. 
+		<1.0.0 > 190228 No changes. 
+		<0.2.1 > 190226 Added PreemptISR macro replacing the old Lin_YieldISR system call for readability. 
+		<0.2.0 > 190208 Added Yield and Preempt functions. 
+		<0.1.1 > 190206 Added support for dynamic priorities. 
+		<0.1.0 > 190203 Initial Release. This is a library for simplified programming. 
+*/ 
+#include <OS.h> 
+#include <Lint.h> 
+
+TASK OS_New(u32 StkSize, void * PC){ 
+	TASK Task = Lin_New(StkSize, PC); 
+	if(Task == NULL) return NULL; 
+	Task->WkupSrc = Src_None; 
+	Task->WkupMeth = Meth_None; 
+	Task->GenEvFlag = 0; 
+	Task->GenEvInfo = 0; 
+	Task->TimeSliceCounter = 10; 
+	Task->TimeSliceReload = 10; 
+	Task->Priority = 0; 
+	Lin_ECB * ECB = Task->ECB; 
+	ECB->TimeBase_Mode = -1; 
+	ECB->TimeBase_Stamp = 0; 
+	ECB->WkupRef = NULL; 
+	ECB->EvListSize = 0; 
+	ECB->MsgCap = 0; 
+	ECB->TxWaiting = 0; 
+	ECB->TxNext = NULL; 
+	ECB->TxOn = NULL; 
+	ECB->TxWaitHead = NULL; 
+	ECB->TxWaitTail = NULL; 
+	ECB->Hist = NULL; 
+	ECB->CallHead = NULL; 
+	ECB->CallTail = NULL; 
+	ECB->CallTaken = NULL; 
+	ECB->CallBlk = NULL; 
+	ECB->CallWait = 0; 
+	ECB->CallDonated = 0; 
+	ECB->CallBase = 0; 
+	Sched_Reg(Task); 
+	return Task; 
+}
+
+void OS_ChgPri(TASK Task, int Priority){ 
+	if(Task == NULL) Task = Lin_GetCurrTask(); 
+	if(Lint_IsDead(Task)) return; 
+	__critical_enter(); 
+	if(Lint_IsNotWaiting(Task)) Task->Priority = Priority; 
+	else{ 
+		PQ_Del(Task); 
+		Task->Priority = Priority; 
+		PQ_Add(Task); 
+	}
+	Sched_Wake(); 
+	__critical_exit(); 
+}
+
+static void OS_CallDrop(TASK Task); 
+static void OS_Dropped(TASK Task, MSG Msg); 
+extern OS_DropFunc OS_DropCall; 
+
+static void OS_TxUnlink(TASK Self){ 	// Take a sender off the mailbox it is queued on, in a critical region. 
+	Lin_ECB * SelfECB = Self->ECB; 
+	Lin_ECB * ECB = SelfECB->TxOn->ECB; 
+	TASK Prev = NULL; 
+	TASK Curr = ECB->TxWaitHead; 
+	while(Curr != Self){ 
+		Prev = Curr; 
+		Curr = Curr->ECB->TxNext; 
+	}
+	if(Prev == NULL) ECB->TxWaitHead = SelfECB->TxNext; 
+	else Prev->ECB->TxNext = SelfECB->TxNext; 
+	if(ECB->TxWaitTail == Self) ECB->TxWaitTail = Prev; 
+	SelfECB->TxWaiting = 0; 
+	SelfECB->TxNext = NULL; 
+}
+
+void OS_Del(TASK Task){ 
+	int self = 0; 
+	if(Task == NULL){ 
+		self = 1; 
+		Task = Lin_GetCurrTask(); 
+	}
+	__critical_enter(); 
+	Lin_ECB * ECB = Task->ECB; 
+	if(ECB->TxWaiting != 0) OS_TxUnlink(Task); 	// Leave the mailbox it is blocked on. 
+	for(TASK Sender = ECB->TxWaitHead; Sender != NULL; ){ 	// Senders blocked on its own return -1. 
+		TASK Next = Sender->ECB->TxNext; 
+		Sender->ECB->TxWaiting = 0; 
+		Sender->ECB->TxNext = NULL; 
+		Sender->ECB->TxOn = NULL; 
+		OS_GenEvent(Sender, 0); 
+		Sender = Next; 
+	}
+	ECB->TxWaitHead = NULL; 
+	ECB->TxWaitTail = NULL; 
+	OS_CallDrop(Task); 
+	Topic_Purge(Task); 
+	MSG Msg; 
+	if(Topic_All != NULL || OS_DropCall != NULL) 	// Someone owns payloads, otherwise Lin_Delete releases the carriers at once. 
+		while(Lin_MsgDrop(Task, &Msg) == 0) OS_Dropped(Task, Msg); 
+	Sched_UnReg(Task); 
+	Lin_Delete(Task); 
+	__critical_exit(); 
+	if(self != 0) OS_Suspend(); 
+}
+
+void OS_GenEvent(TASK Task, u8 info){ 
+	__critical_enter(); 
+	Task->GenEvInfo = info; 
+	Task->GenEvFlag = 1; 
+	Sched_Wake(); 
+	__critical_exit(); 
+}
+
+void OS_TBGperiod(int interval){ 	// In ms, clamped to OS_TBGMaxMs. 
+	if(interval > OS_TBGMaxMs) interval = OS_TBGMaxMs; 
+	OS_TBGperiodUs(interval * 1000); 
+}
+
+void OS_TBGdelay(int time){ 	// In ms, clamped to OS_TBGMaxMs. 
+	if(time > OS_TBGMaxMs) time = OS_TBGMaxMs; 
+	OS_TBGdelayUs(time * 1000); 
+}
+
+void OS_TBGperiodUs(int interval){ 
+	u32 Now = OS_TimeStamp(); 
+	__critical_enter(); 
+	Lin_ECB * ECB = Lin_GetCurrTask()->ECB; 
+	ECB->TimeBase_Mode = interval; 
+	ECB->TimeBase_Stamp = Now + interval; 
+	__critical_exit();  
+}
+
+void OS_TBGdelayUs(int time){ 
+	u32 Now = OS_TimeStamp(); 
+	__critical_enter(); 
+	Lin_ECB * ECB = Lin_GetCurrTask()->ECB; 
+	ECB->TimeBase_Mode = 0; 
+	ECB->TimeBase_Stamp = Now + time; 
+	__critical_exit(); 
+}
+
+void OS_TBGstop(void){ 
+	__critical_enter(); 
+	Lin_ECB * ECB = Lin_GetCurrTask()->ECB; 
+	ECB->TimeBase_Mode = -1; 
+	ECB->TimeBase_Stamp = 0; 
+	__critical_exit(); 
+}
+
+void OS_MsgCap(TASK Task, int Cap){ 	// Bound the mailbox of a task, 0 for unbounded. 
+	if(Task == NULL) Task = Lin_GetCurrTask(); 
+	Task->ECB->MsgCap = Cap; 
+}
+
+OS_DropFunc OS_DropCall; 	// Owner hook for dropped Messages 
+
+void OS_DropHook(OS_DropFunc Func){ 	// Called with each Message Tx_Over drops, in the context of the sender, ISRs included, 
+	// and with each Message left to a task being deleted, inside the critical region of OS_Del. 
+	OS_DropCall = Func; 
+}
+
+static void OS_Dropped(TASK Task, MSG Msg){ 	// A Message discarded before its receiver saw it. 
+	if(Msg.Src == Topic_Src) Topic_Release(Msg.Pld); 	// Reference counted, the receiver would have released it. 
+	else if(OS_DropCall != NULL) OS_DropCall(Task, Msg); 
+}
+
+int OS_TxMsgEx(TASK Task, MSG Msg, int Mode){ 	// Send with backpressure. Returns 0 if enqueued, -1 if not. 
+	return OS_TxMsgL(Task, Msg, 0, Mode); 
+}
+
+int OS_TxMsgL(TASK Task, MSG Msg, int Lane, int Mode){ 	// Send in a priority lane, see Lin_MsgPutL. The capacity covers all lanes. 
+	Lin_ECB * ECB = Task->ECB; 
+	for(;;){ 
+		__critical_enter(); 
+		int Cap = ECB->MsgCap; 
+		if(Cap <= 0 || Task->MsgQty < Cap){ 	// Room left. 
+			int Ret = Lin_MsgPutL(Task, Msg, Lane); 
+			Sched_Wake(); 
+			__critical_exit(); 
+			return Ret; 
+		}
+		if(Mode == Tx_Over){ 	// Drop the oldest of the lowest lane, its owner is told after the region. 
+			MSG Old; 
+			int Dropped = (Lin_MsgDrop(Task, &Old) == 0); 
+			int Ret = Lin_MsgPutL(Task, Msg, Lane); 
+			Sched_Wake(); 
+			__critical_exit(); 
+			if(Dropped) OS_Dropped(Task, Old); 
+			return Ret; 
+		}
+		if(Mode != Tx_Block || (SCB->ICSR & 0x1FF) != 0){ 	// Fail fast, and never block in ISRs. 
+			__critical_exit(); 
+			return -1; 
+		}
+		TASK Self = Lin_GetCurrTask(); 
+		Lin_ECB * SelfECB = Self->ECB; 
+		if(SelfECB->TxWaiting == 0){ 	// Park on the mailbox, woken by OS_RxMsg of the receiver. 
+			SelfECB->TxWaiting = 1; 
+			SelfECB->TxOn = Task; 
+			SelfECB->TxNext = NULL; 
+			if(ECB->TxWaitTail == NULL) ECB->TxWaitHead = Self; 
+			else ECB->TxWaitTail->ECB->TxNext = Self; 
+			ECB->TxWaitTail = Self; 
+		}
+		__critical_exit(); 
+		OS_Suspend(); 
+		__critical_reenter(); 
+		if(SelfECB->TxOn != Task){ 	// The receiver was deleted meanwhile, its ECB is gone. 
+			__critical_exit(); 
+			return -1; 
+		}
+		if(SelfECB->TxWaiting != 0) OS_TxUnlink(Self); 	// Woken or not, leave the queue before retrying. 
+		__critical_exit(); 
+	}
+}
+
+void OS_TxWake(TASK Task, u32 N){ 	// Wake up to N senders blocked on the mailbox of a task. 
+	Lin_ECB * ECB = Task->ECB; 		// Woken senders stay queued until they run, so OS_Del of the receiver still finds them. 
+	while(N-- > 0){ 
+		__critical_enter(); 
+		TASK Sender = ECB->TxWaitHead; 
+		while(Sender != NULL && Sender->ECB->TxWaiting != 1) Sender = Sender->ECB->TxNext; 
+		if(Sender != NULL){ 
+			Sender->ECB->TxWaiting = 2; 
+			OS_GenEvent(Sender, 0); 
+		}
+		__critical_exit(); 
+		if(Sender == NULL) return; 
+	}
+}
+
+MSG OS_RxMsg(void){ 	// Receive, and let one blocked sender in. 
+	MSG Msg = Lin_MsgRecv(); 
+	OS_TxWake(Lin_GetCurrTask(), 1); 
+	return Msg; 
+}
+
+u32 OS_RxMsgN(MSG * Msg, u32 Max){ 	// Receive up to Max, and let as many blocked senders in. 
+	u32 N = Lin_MsgRecvN(Msg, Max); 
+	OS_TxWake(Lin_GetCurrTask(), N); 
+	return N; 
+}
+
+int OS_TxMsgN(TASK Task, const MSG * Msg, u32 N){ 	// Send N Messages in one region, all or none. Returns 0, or -1 past MsgCap or out of carriers. 
+	__critical_enter(); 
+	int Cap = Task->ECB->MsgCap; 
+	if(Cap > 0 && (u32)Task->MsgQty + N > (u32)Cap){ 
+		__critical_exit(); 
+		return -1; 
+	}
+	int Ret = Lin_MsgPutN(Task, Msg, N); 
+	if(Ret == 0 && N > 0) Sched_Wake(); 
+	__critical_exit(); 
+	return Ret; 
+}
+
+u32 OS_MvMsg(TASK Dst, TASK Src){ 	// Move every Message of Src to Dst. Returns how many, 0 when Dst has no room for all. 
+	__critical_enter(); 
+	int Cap = Dst->ECB->MsgCap; 
+	if(Cap > 0 && Dst->MsgQty + Src->MsgQty > Cap){ 
+		__critical_exit(); 
+		return 0; 
+	}
+	u32 N = Lin_MsgSplice(Dst, Src); 
+	if(N > 0) Sched_Wake(); 
+	__critical_exit(); 
+	OS_TxWake(Src, N); 	// Src has room again. 
+	return N; 
+}
+
+static void OS_TBGrestore(Lin_ECB * ECB, int Mode, u32 Stamp){ 	// Put back a TBG set aside by a wait. In a critical region. 
+	u32 Now = OS_TimeStamp(); 
+	if(Mode >= 0 && (s32)(Now - Stamp) >= 0){ 	// Came due during the wait. 
+		if(Mode == 0) Mode = -1; 	// A one-shot was overtaken by the wait, releasing now would be spurious. 
+		else Stamp += ((Now - Stamp) / Mode + 1) * Mode; 	// A periodic one keeps its phase. 
+	}
+	ECB->TimeBase_Mode = Mode; 
+	ECB->TimeBase_Stamp = Stamp; 
+}
+
+static int OS_EvStale(void * EvRef, u32 Epoch){ 	// A broadcast latched no later than the epoch a wait was armed in. 
+	return EvRef != NULL && *(int *)EvRef == Ev_TypeBcst && !Ev_BcstSince((Ev_Bcst *)EvRef, Epoch); 
+}
+
+int OS_WaitAny(void ** EvRef, int N, int Timeout){ 	// Block until any event fires or Timeout ms pass, < 0 waits forever. 
+	// Returns the index of the fired event (consumed), Src_TBG on timeout, Src_Gen on a Generic Event 
+	// or OS_WaitErr when N exceeds Lin_EvListMax. Timeout is clamped to OS_TBGMaxMs. 
+	// Any TBG set up before is put aside during the wait and restored afterwards, see OS_TBGrestore. 
+	TASK Self = Lin_GetCurrTask(); 
+	Lin_ECB * ECB = Self->ECB; 
+	if(N < 0 || N > Lin_EvListMax) return OS_WaitErr; 
+	if(Timeout > OS_TBGMaxMs) Timeout = OS_TBGMaxMs; 
+	for(int i = 0; i < N; i++) 	// A broadcast only releases tasks already waiting. 
+		if(*(int *)EvRef[i] != Ev_TypeBcst && Ev_Query(EvRef[i])) return i; 
+	if(Timeout == 0) return Src_TBG; 
+	__critical_enter(); 
+	int TbMode = ECB->TimeBase_Mode; 
+	u32 TbStamp = ECB->TimeBase_Stamp; 
+	u32 Epoch = Ev_Epoch(); 	// A broadcast only releases tasks already waiting, see OS_EvStale. 
+	for(int i = 0; i < N; i++) ECB->EvList[i] = EvRef[i]; 
+	ECB->EvListSize = N; 
+	ECB->TimeBase_Mode = (Timeout > 0) ? 0 : -1; 
+	ECB->TimeBase_Stamp = OS_TimeStamp() + Timeout * 1000; 
+	__critical_exit(); 
+	int Ret; 
+	for(;;){ 
+		do OS_Suspend(); 
+		while(Self->WkupSrc == Src_None); 
+		Ret = Self->WkupSrc; 
+		if(Ret != Src_Ev) break; 
+		int i = 0; 
+		while(i < N && ECB->WkupRef != EvRef[i]) i++; 
+		if(i < N && !OS_EvStale(EvRef[i], Epoch)){ 
+			Ret = i; 
+			break; 
+		}
+		// Not one of ours or a broadcast from before the wait, the list is still armed. 
+	}
+	__critical_reenter(); 
+	ECB->EvListSize = 0; 	// Disarm everything. 
+	OS_TBGrestore(ECB, TbMode, TbStamp); 
+	__critical_exit(); 
+	return Ret; 
+}
+
+int OS_WaitAll(void ** EvRef, int N, int Timeout){ 	// Block until all events fire or Timeout ms pass, < 0 waits forever. 
+	// Returns 0 when all fired, Src_TBG on timeout, Src_Gen on a Generic Event or OS_WaitErr when 
+	// N exceeds Lin_EvListMax. Events fired before a timeout stay consumed. 
+	TASK Self = Lin_GetCurrTask(); 
+	Lin_ECB * ECB = Self->ECB; 
+	if(N < 0 || N > Lin_EvListMax) return OS_WaitErr; 
+	if(Timeout > OS_TBGMaxMs) Timeout = OS_TBGMaxMs; 
+	u32 All = (N < 32) ? (1u << N) - 1 : 0xFFFFFFFF; 
+	u32 Done = 0; 
+	for(int i = 0; i < N; i++) 
+		if(*(int *)EvRef[i] != Ev_TypeBcst && Ev_Query(EvRef[i])) Done |= 1u << i; 
+	if(Done == All) return 0; 
+	if(Timeout == 0) return Src_TBG; 
+	__critical_enter(); 
+	int TbMode = ECB->TimeBase_Mode; 
+	u32 TbStamp = ECB->TimeBase_Stamp; 
+	ECB->TimeBase_Mode = (Timeout > 0) ? 0 : -1; 
+	ECB->TimeBase_Stamp = OS_TimeStamp() + Timeout * 1000; 
+	u32 Epoch = Ev_Epoch(); 	// Kept for the whole wait, re-arming does not make a task a later waiter. 
+	__critical_exit(); 
+	int Ret = 0; 
+	while(Done != All){ 
+		__critical_reenter(); 	// Arm the events still pending. 
+		int k = 0; 
+		for(int i = 0; i < N; i++) 
+			if((Done & (1u << i)) == 0) ECB->EvList[k++] = EvRef[i]; 
+		ECB->EvListSize = k; 
+		__critical_exit(); 
+		OS_Suspend(); 
+		int Src = Self->WkupSrc; 
+		if(Src == Src_TBG || Src == Src_Gen){ 
+			Ret = Src; 
+			break; 
+		}
+		if(Src != Src_Ev) continue; 
+		for(int i = 0; i < N; i++){ 
+			if((Done & (1u << i)) == 0 && ECB->WkupRef == EvRef[i]){ 
+				if(!OS_EvStale(EvRef[i], Epoch)) Done |= 1u << i; 
+				break; 
+			}
+		}
+	}
+	__critical_reenter(); 
+	ECB->EvListSize = 0; 	// Disarm everything. 
+	OS_TBGrestore(ECB, TbMode, TbStamp); 
+	__critical_exit(); 
+	return Ret; 
+}
+
+int OS_EvWait(void * EvRef){ 	// Block until the event fires. The event is consumed on return. 
+	while(OS_WaitAny(&EvRef, 1, -1) != 0); 	// Other sources are not what we wait for. 
+	return 0; 
+}
+
+int OS_StkReport(OS_StkInfo * Info, int Max){ 	// Stack usage of the scheduler and every registered task. Returns the number reported. 
+	// Run it after the system has been through its workload, the high-water marks only grow. 
+	int N = 0; 
+	__critical_enter(); 
+	if(N < Max) Info[N++].Task = Lin_GetMainTask(); 
+	for(TASK Task = PQ_Trav(NULL); Task != NULL && N < Max; Task = PQ_Trav(Task)) Info[N++].Task = Task; 
+	for(TASK Task = DL_Trav(NULL); Task != NULL && N < Max; Task = DL_Trav(Task)) Info[N++].Task = Task; 
+	__critical_exit(); 
+	for(int i = 0; i < N; i++){ 	// Scanning outside the critical region. 
+		TASK Task = Info[i].Task; 
+		u32 Size = Lin_StkSize(Task); 
+		u32 Used = Size - Lin_StkFree(Task); 
+		Info[i].Size = Size; 
+		Info[i].Used = Used; 
+		Info[i].Suggest = (Used + Used / 4 + 7) & ~7; 
+	}
+	return N; 
+}
+
+// Synchronous calls: the client blocks in OS_Call until the server answers with OS_Reply. 
+/*	Nothing is allocated, the call block and both messages stay on the stacks of the two tasks. 
+		A server with a lower priority than a caller inherits it until the queued and accepted callers are answered. 
+		When the server is blocked in OS_Accept on the same core, OS_Call switches to it directly 
+		instead of going through a scheduler pass, and OS_Reply switches straight back to a client 
+		at least as urgent as the server. Otherwise both fall back to Generic Events. 
+		The switch is pended with Lin_SwitchISR inside the critical region and taken on leaving it, 
+		so a tick arriving in between just turns it into an ordinary pass. 
+		A Generic Event sent to a blocked client by someone else is consumed by OS_Call. 
+		Calls may be answered in any order. Deleting a client withdraws its call, deleting a server 
+		fails its pending calls with -1. 
+*/
+static int OS_CallPri(TASK Server){ 	// Base priority raised to the most urgent caller, queued or accepted. 
+	Lin_ECB * ECB = Server->ECB; 
+	int Pri = ECB->CallBase; 
+	for(OS_CallBlk * Call = (OS_CallBlk *)ECB->CallHead; Call != NULL; Call = Call->Next) 
+		if(Call->Client->Priority < Pri) Pri = Call->Client->Priority; 
+	for(OS_CallBlk * Call = (OS_CallBlk *)ECB->CallTaken; Call != NULL; Call = Call->Next) 
+		if(Call->Client->Priority < Pri) Pri = Call->Client->Priority; 
+	return Pri; 
+}
+
+static void OS_CallUndonate(TASK Server){ 	// Give back what answered or vanished callers lent. In a critical region. 
+	Lin_ECB * ECB = Server->ECB; 
+	if(ECB->CallDonated == 0) return; 
+	int Pri = OS_CallPri(Server); 
+	if(Pri == ECB->CallBase) ECB->CallDonated = 0; 
+	OS_ChgPri(Server, Pri); 
+}
+
+static int OS_CallUnlink(void ** Head, void ** Tail, OS_CallBlk * Call){ 	// Returns 1 if Call was on the list. 
+	OS_CallBlk * Prev = NULL; 
+	OS_CallBlk * Curr = (OS_CallBlk *)*Head; 
+	while(Curr != NULL && Curr != Call){ 
+		Prev = Curr; 
+		Curr = Curr->Next; 
+	}
+	if(Curr == NULL) return 0; 
+	if(Prev == NULL) *Head = Call->Next; 
+	else Prev->Next = Call->Next; 
+	if(Tail != NULL && *Tail == Call) *Tail = Prev; 
+	return 1; 
+}
+
+static void OS_CallDrop(TASK Task){ 	// Calls involving a task being deleted. In a critical region. 
+	Lin_ECB * ECB = Task->ECB; 
+	OS_CallBlk * Call = (OS_CallBlk *)ECB->CallBlk; 
+	if(Call != NULL){ 	// A client: withdraw its call, the server never sees it or finds nothing to answer. 
+		Lin_ECB * SrvECB = Call->Server->ECB; 
+		if(!OS_CallUnlink(&SrvECB->CallHead, &SrvECB->CallTail, Call)) OS_CallUnlink(&SrvECB->CallTaken, NULL, Call); 
+		ECB->CallBlk = NULL; 
+		OS_CallUndonate(Call->Server); 
+	}
+	for(int i = 0; i < 2; i++){ 	// A server: every queued or accepted call fails with -1. 
+		Call = (OS_CallBlk *)(i == 0 ? ECB->CallHead : ECB->CallTaken); 
+		while(Call != NULL){ 
+			OS_CallBlk * Next = Call->Next; 
+			Call->Client->ECB->CallBlk = NULL; 
+			Call->Done = -1; 
+			OS_GenEvent(Call->Client, 0); 
+			Call = Next; 
+		}
+	}
+	ECB->CallHead = NULL; 
+	ECB->CallTail = NULL; 
+	ECB->CallTaken = NULL; 
+}
+
+static int OS_CanHandoff(TASK Task){ 	// Task blocked in the Standby List, and no lock held. 
+	return !Lint_IsDead(Task) && Lint_IsNotWaiting(Task) && !Sched_IsLocked(); 
+}
+
+static void OS_Handoff(TASK Self, TASK Task, int Block){ 	// Ready Task, block Self if asked, and pend a switch to Task. In a critical region. 
+	Sched_SetRunning(Task); 
+	DL_Del(Task); 
+	PQ_Add(Task); 
+	if(Block && !Lint_IsNotWaiting(Self)){ 
+		PQ_Del(Self); 
+		DL_Add(Self); 
+	}
+	Load_Enter(); 
+	Load_Leave(Task); 
+	Lin_SwitchISR(Task); 
+}
+
+int OS_Call(TASK Server, MSG Msg, MSG * Reply){ 	// Returns 0 when answered, -1 for a dead or deleted server or a call to self. 
+	TASK Self = Lin_GetCurrTask(); 
+	if(Server == NULL || Server == Self || Lint_IsDead(Server)) return -1; 
+	Lin_ECB * ECB = Server->ECB; 
+	OS_CallBlk Call; 
+	Call.Next = NULL; 
+	Call.Client = Self; 
+	Call.Server = Server; 
+	Call.Msg = Msg; 
+	Call.Done = 0; 
+	__critical_enter(); 
+	if(ECB->CallTail == NULL) ECB->CallHead = &Call; 
+	else ((OS_CallBlk *)ECB->CallTail)->Next = &Call; 
+	ECB->CallTail = &Call; 
+	Self->ECB->CallBlk = &Call; 
+	if(Self->Priority < Server->Priority){ 	// Donate. 
+		if(ECB->CallDonated == 0){ 
+			ECB->CallDonated = 1; 
+			ECB->CallBase = Server->Priority; 
+		}
+		OS_ChgPri(Server, Self->Priority); 
+	}
+	if(ECB->CallWait != 0 && OS_CanHandoff(Server)){ 
+		ECB->CallWait = 0; 
+		OS_Handoff(Self, Server, 1); 
+		__critical_exit(); 	// Switches here. 
+	}
+	else{ 
+		__critical_exit(); 
+		OS_GenEvent(Server, 0); 
+	}
+	while(Call.Done == 0) OS_Suspend(); 
+	if(Call.Done < 0) return -1; 
+	if(Reply != NULL) *Reply = Call.Reply; 
+	return 0; 
+}
+
+TASK OS_Accept(MSG * Msg){ 	// Block until a call arrives. Returns the client to answer. 
+	Lin_ECB * ECB = Lin_GetCurrTask()->ECB; 
+	for(;;){ 
+		__critical_enter(); 
+		OS_CallBlk * Call = (OS_CallBlk *)ECB->CallHead; 
+		if(Call != NULL){ 
+			ECB->CallHead = Call->Next; 
+			if(Call->Next == NULL) ECB->CallTail = NULL; 
+			Call->Next = (OS_CallBlk *)ECB->CallTaken; 	// Still donating until answered. 
+			ECB->CallTaken = Call; 
+			ECB->CallWait = 0; 
+			TASK Client = Call->Client; 	// Read before leaving, a deleted client takes the block with it. 
+			*Msg = Call->Msg; 
+			__critical_exit(); 
+			return Client; 
+		}
+		ECB->CallWait = 1; 
+		__critical_exit(); 
+		OS_Suspend(); 
+	}
+}
+
+void OS_Reply(TASK Client, MSG Reply){ 	// Answer an accepted call. A client deleted meanwhile is skipped. 
+	TASK Self = Lin_GetCurrTask(); 
+	Lin_ECB * ECB = Self->ECB; 
+	__critical_enter(); 
+	OS_CallBlk * Call = (OS_CallBlk *)ECB->CallTaken; 	// Found by address, a deleted client is never dereferenced. 
+	while(Call != NULL && Call->Client != Client) Call = Call->Next; 
+	if(Call == NULL){ 
+		__critical_exit(); 
+		return; 
+	}
+	OS_CallUnlink(&ECB->CallTaken, NULL, Call); 
+	Client->ECB->CallBlk = NULL; 
+	Call->Reply = Reply; 
+	Call->Done = 1; 
+	OS_CallUndonate(Self); 	// Keep what the other queued or accepted callers lend. 
+	if(Client->Priority <= Self->Priority && OS_CanHandoff(Client)){ 
+		OS_Handoff(Self, Client, 0); 
+		__critical_exit(); 	// Switches here, Self stays ready. 
+	}
+	else{ 
+		__critical_exit(); 
+		OS_GenEvent(Client, 0); 
+	}
+}
+
+void OS_Yield(void){ 
+	MSG Msg; 
+	Msg.Cmd = 0x1; 
+	Msg.Src = 0x0; 
+	Msg.Pld = Lin_GetCurrTask(); 
+	Lin_MsgSubmit(Msg); 
+	Lin_Yield(); 
+}
+
+void OS_Suspend(void){ 
+	MSG Msg; 
+	Msg.Cmd = 0x0; 
+	Msg.Src = 0x0; 
+	Msg.Pld = Lin_GetCurrTask(); 
+	Lin_MsgSubmit(Msg); 
+	Lin_Yield(); 
+}
+
+// End of file. 
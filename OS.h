@@ -1,41 +1,112 @@
-// lyrinka OS version 1.0.2 header file 
-#ifndef __OS_H__ 
-#define __OS_H__ 
-
-#ifdef __cplusplus 
-extern "C" { 
-#endif 
-
-#include <Lin.h> 
-#include <Sched.h> 
-#include <Event.h> 
-
-extern u32 TickCount; 
-
-TASK OS_New(u32 StkSize, void * PC); 
-void OS_ChgPri(TASK Task, int Priority); 
-void OS_Del(TASK Task); 
-
-void OS_GenEvent(TASK Task, u8 info); 
-void OS_TBGperiod(int interval); 
-void OS_TBGdelay(int time); 
-void OS_TBGstop(void); 
-
-#define OS_PreemptISR() Lin_YieldISR() 
-#define OS_Preempt() Lin_Yield() 
-void OS_Yield(void); 
-void OS_Suspend(void); 
-
-#define OS_Lock() Sched_Lock() 
-#define OS_UnLock() Sched_UnLock() 
-#define OS_ClrLock() Sched_ClrLock() 
-
-#define OS_TxMsg(task, msg) Lin_MsgPut(task, msg) 
-#define OS_RxCnt() Lin_MsgQty() 
-#define OS_RxMsg() Lin_MsgRecv() 
-
-#ifdef __cplusplus 
-}
-#endif 
-
-#endif 
+// lyrinka OS version 1.12.1 header file 
+#ifndef __OS_H__ 
+#define __OS_H__ 
+
+#ifdef __cplusplus 
+extern "C" { 
+#endif 
+
+#include <Lin.h> 
+#include <Sched.h> 
+#include <Event.h> 
+#include <Topic.h> 
+#include <Timer.h> 
+#include <Load.h> 
+#include <Pool.h> 
+#include <Stream.h> 
+#include <Met.h> 
+#include <Seq.h> 
+
+extern u32 TickCount; 
+unsigned long long OS_TimeUs(void); 
+#define OS_TimeStamp() ((u32)OS_TimeUs()) 
+
+#ifdef SIM 
+#define Sim_PassUs 	10 	// Virtual time charged for each scheduling pass that runs a task 
+extern unsigned long long Sim_TimeUs; 
+void Sim_Seed(u32 Seed); 
+u32  Sim_Rand(void); 
+#endif 
+
+TASK OS_New(u32 StkSize, void * PC); 
+void OS_ChgPri(TASK Task, int Priority); 
+void OS_Del(TASK Task); 
+
+// Release latency and response time histograms 
+#define OS_HistAttach(task, hist) Sched_HistAttach(task, hist) 
+#define OS_HistReset(hist) Sched_HistClr(hist) 
+#define OS_HistPct(bucket, pct) Sched_HistPct(bucket, pct) 
+
+void OS_GenEvent(TASK Task, u8 info); 
+#define OS_TBGMaxMs 2147483 	// Longest TBG in ms, the microsecond stamps wrap beyond 
+void OS_TBGperiod(int interval); 
+void OS_TBGdelay(int time); 
+void OS_TBGperiodUs(int interval); 
+void OS_TBGdelayUs(int time); 
+void OS_TBGstop(void); 
+
+// Stack usage of a task, see OS_StkReport 
+typedef struct OS_StkInfo{ 
+	TASK Task; 
+	u32 Size; 		// Given to OS_New 
+	u32 Used; 		// High-water mark 
+	u32 Suggest; 	// Used plus a quarter, the size worth giving next time 
+}OS_StkInfo; 
+
+int  OS_StkReport(OS_StkInfo * Info, int Max); 
+
+// Fixed block pools, ISR safe 
+#define OS_PoolCreate(size, cnt) Pool_Create(size, cnt) 
+#define OS_PoolAlloc(pool) Pool_Alloc(pool) 
+#define OS_PoolFree(pool, blk) Pool_Free(pool, blk) 
+
+#define OS_PreemptISR() Lin_YieldISR() 
+#define OS_Preempt() Lin_Yield() 
+#define OS_WaitErr -3 	// Wait set larger than Lin_EvListMax, nothing waited for 
+int  OS_WaitAny(void ** EvRef, int N, int Timeout); 
+int  OS_WaitAll(void ** EvRef, int N, int Timeout); 
+int  OS_EvWait(void * EvRef); 
+void OS_Yield(void); 
+void OS_Suspend(void); 
+
+#define OS_Lock() Sched_Lock() 
+#define OS_UnLock() Sched_UnLock() 
+#define OS_ClrLock() Sched_ClrLock() 
+
+#define Tx_Fail  0 // Fail when the mailbox is full. 
+#define Tx_Over  1 // Overwrite the oldest message when the mailbox is full, see OS_DropHook. 
+#define Tx_Block 2 // Block the sender until the receiver makes room. Tasks only, fails if the receiver is deleted. 
+
+void OS_MsgCap(TASK Task, int Cap); 
+int  OS_TxMsgEx(TASK Task, MSG Msg, int Mode); 
+int  OS_TxMsgL(TASK Task, MSG Msg, int Lane, int Mode); 
+void OS_TxWake(TASK Task, u32 N); 
+MSG  OS_RxMsg(void); 
+u32  OS_RxMsgN(MSG * Msg, u32 Max); 
+int  OS_TxMsgN(TASK Task, const MSG * Msg, u32 N); 
+u32  OS_MvMsg(TASK Dst, TASK Src); 
+
+#define OS_TxMsg(task, msg) OS_TxMsgEx(task, msg, Tx_Fail) 
+typedef void (* OS_DropFunc)(TASK Task, MSG Msg); 
+void OS_DropHook(OS_DropFunc Func); 
+#define OS_RxCnt() Lin_MsgQty() 
+// Synchronous calls, see OS_Call 
+typedef struct OS_CallBlk{ 	// !!Internal, lives on the client stack 
+	struct OS_CallBlk * Next; 
+	TASK Client; 
+	TASK Server; 
+	MSG Msg; 
+	MSG Reply; 
+	volatile int Done; 	// 1 answered, -1 failed by the deletion of the server 
+}OS_CallBlk; 
+
+int  OS_Call(TASK Server, MSG Msg, MSG * Reply); 
+TASK OS_Accept(MSG * Msg); 
+void OS_Reply(TASK Client, MSG Reply); 
+
+
+#ifdef __cplusplus 
+}
+#endif 
+
+#endif 
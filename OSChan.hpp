@@ -0,0 +1,120 @@
+// lyrinka OS Typed Channel version 0.1.0 header file 
+/* Release Notes: 
+
+		<0.1.0 > 261019 Initial Release. Zero-copy Channel<T, N> over a static ring of T slots. 
+*/
+/* Comments: 
+	A Channel<T, N> carries objects of type T between one producer and one consumer 
+	without copies or allocations: the ring of N slots is part of the channel object. 
+
+	Producer: 
+		Sample * S = Chan.reserve(); 	// Blocks while the ring is full. 
+		new (S) Sample(...); 			// Construct in place. 
+		Chan.commit(); 					// Publish, wakes the consumer. 
+	Consumer: 
+		Sample * S = Chan.borrow(); 	// Blocks while the ring is empty. 
+		Use(S); 
+		Chan.release(); 				// Destroys the object, wakes the producer. 
+
+	Blocking goes through the scheduler: the waiting task OS_Suspend()s 
+	and the other side wakes it with OS_GenEvent. 
+	tryReserve() and tryBorrow() never block and may be used from ISRs. 
+	Only one reservation and one borrow may be outstanding at a time. 
+*/
+#ifndef __OSChan_HPP__ 
+#define __OSChan_HPP__ 
+
+#include <OS.h> 
+#include <new> 
+#include <utility> 
+
+namespace os { 
+
+template<typename T, u32 N> 
+class Channel{ 
+	static_assert(N > 0 && (N & (N - 1)) == 0, "Channel size must be a power of 2"); 
+public: 
+	Channel() : Head(0), Tail(0), Writer(nullptr), Reader(nullptr) {}
+	Channel(const Channel &) = delete; 
+	Channel & operator=(const Channel &) = delete; 
+	~Channel(){ while(tryBorrow() != nullptr) release(); }
+
+	// Producer side. 
+	T * tryReserve(void){ 
+		if(Head - Tail >= N) return nullptr; 
+		return at(Head); 
+	}
+	T * reserve(void){ 
+		for(;;){ 
+			u32 IE = __get_PRIMASK(); 
+			__disable_irq(); 
+			if(Head - Tail < N){ 
+				__set_PRIMASK(IE); 
+				return at(Head); 
+			}
+			Writer = Lin_GetCurrTask(); 
+			__set_PRIMASK(IE); 
+			OS_Suspend(); 
+		}
+	}
+	void commit(void){ 
+		u32 IE = __get_PRIMASK(); 
+		__disable_irq(); 
+		Head = Head + 1; 
+		TASK Task = Reader; 
+		Reader = nullptr; 
+		__set_PRIMASK(IE); 
+		if(Task != nullptr) OS_GenEvent(Task, 0); 
+	}
+	template<typename... A> 
+	void send(A &&... Args){ 
+		new (reserve()) T(std::forward<A>(Args)...); 
+		commit(); 
+	}
+
+	// Consumer side. 
+	T * tryBorrow(void){ 
+		if(Head == Tail) return nullptr; 
+		return at(Tail); 
+	}
+	T * borrow(void){ 
+		for(;;){ 
+			u32 IE = __get_PRIMASK(); 
+			__disable_irq(); 
+			if(Head != Tail){ 
+				__set_PRIMASK(IE); 
+				return at(Tail); 
+			}
+			Reader = Lin_GetCurrTask(); 
+			__set_PRIMASK(IE); 
+			OS_Suspend(); 
+		}
+	}
+	void release(void){ 
+		at(Tail)->~T(); 
+		u32 IE = __get_PRIMASK(); 
+		__disable_irq(); 
+		Tail = Tail + 1; 
+		TASK Task = Writer; 
+		Writer = nullptr; 
+		__set_PRIMASK(IE); 
+		if(Task != nullptr) OS_GenEvent(Task, 0); 
+	}
+
+	u32 count(void) const { return Head - Tail; }
+
+private: 
+	alignas(T) u8 Slot[N][sizeof(T)]; 
+	volatile u32 Head; 		// Free running, advanced by commit. 
+	volatile u32 Tail; 		// Free running, advanced by release. 
+	TASK volatile Writer; 	// Producer parked on full. 
+	TASK volatile Reader; 	// Consumer parked on empty. 
+
+	T * at(u32 Index){ return reinterpret_cast<T *>(Slot[Index & (N - 1)]); }
+}; 
+
+} // namespace os 
+
+#endif 
+
+// End of file. 
@@ -0,0 +1,312 @@
+// lyrinka OS C++20 Coroutine Layer version 0.1.2 header file 
+/* Release Notes: 
+
+		<0.1.2 > 261019 Broadcasts only release activities armed before they were signalled, once per epoch. 
+		<0.1.1 > 261019 The frame pool is a Pool library pool. 
+		<0.1.0 > 261019 Initial Release. Awaitable TBG delays, messages and events. 
+*/
+/* Comments: 
+	Many logical activities (coroutines) share one Lin task and its stack. 
+	An os::Loop runs inside an ordinary task, resumes the activities that are ready, 
+	and when none is ready it arms the TBG and the Event List of its own ECB 
+	with the nearest deadline and pending events, then OS_Suspend()s. 
+
+	Awaitables: 
+		co_await os::delay(ms); 		// Via the TBG of the hosting task, in TickCount ms. 
+		MSG Msg = co_await os::recv(); 	// Via the message queue of the hosting task. 
+		co_await os::event(EvRef); 		// Via the Event List of the hosting ECB. 
+
+	Messages do not wake a task by themselves, 
+	so senders should follow OS_TxMsg with OS_GenEvent as usual. 
+	Only the first Lin_EvListMax pending events are armed in the ECB, 
+	the rest are polled every millisecond. 
+	As with OS_WaitAny, a broadcast only releases activities already waiting: each one 
+	latches the epoch it was armed in and takes a broadcast latched after it, exactly once. 
+
+	Frames come from a fixed block pool of OS_CoroFrameCnt blocks of OS_CoroFrameSize bytes, 
+	never from the heap. An activity whose frame does not fit is not spawned. 
+
+	Example: 
+		os::Act Blink(int Period){ 
+			for(;;){ 
+				LED_Toggle(); 
+				co_await os::delay(Period); 
+			}
+		}
+		void coTask(TASK Self){ 
+			os::Loop Loop; 
+			Loop.spawn(Blink(500)); 
+			Loop.spawn(Blink(300)); 
+			Loop.run(); 	// Returns when all activities have finished. 
+			OS_Del(NULL); 
+		}
+*/
+#ifndef __OSCoro_HPP__ 
+#define __OSCoro_HPP__ 
+
+#include <OS.h> 
+#include <coroutine> 
+#include <cstddef> 
+
+// Configuration 
+#ifndef OS_CoroFrameSize 
+#define OS_CoroFrameSize 	128 
+#endif 
+#ifndef OS_CoroFrameCnt 
+#define OS_CoroFrameCnt 	16 
+#endif 
+
+namespace os { 
+
+class Loop; 
+
+namespace detail { 
+
+// Coroutine frame pool. 
+alignas(8) inline u8 FrameMem[Pool_MemSize(OS_CoroFrameSize, OS_CoroFrameCnt)]; 
+inline Pool_Blk FramePool; 
+inline int FrameReady = 0; 
+
+inline void * FrameGet(std::size_t Size){ 
+	if(Size > OS_CoroFrameSize) return nullptr; 
+	if(FrameReady == 0){ 	// Build the pool on first use. 
+		u32 IE = __get_PRIMASK(); 
+		__disable_irq(); 
+		if(FrameReady == 0) Pool_Init(&FramePool, FrameMem, OS_CoroFrameSize, OS_CoroFrameCnt); 
+		FrameReady = 1; 
+		__set_PRIMASK(IE); 
+	}
+	return Pool_Alloc(&FramePool); 
+}
+inline void FrameRet(void * Mem){ 
+	Pool_Free(&FramePool, Mem); 
+}
+
+// What a parked activity is waiting for. 
+enum{ 
+	Kind_Ready = 0, 
+	Kind_Delay = 1, 
+	Kind_Msg = 2, 
+	Kind_Ev = 3, 
+}; 
+
+// Wait node, one per activity, embedded in its promise. 
+struct Wait{ 
+	Wait * Next; 
+	std::coroutine_handle<> Handle; 
+	int Kind; 
+	u32 Stamp; 		// Deadline in TickCount for Kind_Delay, epoch armed in for Kind_Ev. 
+	void * EvRef; 	// Event Reference for Kind_Ev. 
+}; 
+
+inline bool IsBcst(void * EvRef){ return *(int *)EvRef == Ev_TypeBcst; }
+
+// A broadcast is taken against the epoch latched at arming, anything else is queried and consumed. 
+inline bool EvFired(Wait * W){ 
+	if(IsBcst(W->EvRef)) return Ev_BcstSince((Ev_Bcst *)W->EvRef, W->Stamp); 
+	return Ev_Query(W->EvRef) != 0; 
+}
+
+} // namespace detail 
+
+// Activity: a coroutine run by an os::Loop. 
+class Act{ 
+public: 
+	struct promise_type{ 
+		detail::Wait Node; 
+		Loop * Owner = nullptr; 
+
+		static void * operator new(std::size_t Size) noexcept { return detail::FrameGet(Size); }
+		static void operator delete(void * Mem) noexcept { detail::FrameRet(Mem); }
+		static Act get_return_object_on_allocation_failure() noexcept { return Act(nullptr); }
+
+		Act get_return_object() noexcept { return Act(std::coroutine_handle<promise_type>::from_promise(*this)); }
+		std::suspend_always initial_suspend() noexcept { return {}; }
+		std::suspend_never final_suspend() noexcept { return {}; }
+		void return_void() noexcept {}
+		void unhandled_exception() noexcept { __disable_irq(); for(;;); }
+		~promise_type(); 
+	}; 
+	using Handle = std::coroutine_handle<promise_type>; 
+
+	Act(Act && Other) noexcept : H(Other.H) { Other.H = nullptr; }
+	Act(const Act &) = delete; 
+	Act & operator=(const Act &) = delete; 
+	~Act(){ if(H) H.destroy(); } 	// Never spawned. 
+
+private: 
+	explicit Act(Handle h) noexcept : H(h) {}
+	Handle H; 
+	friend class Loop; 
+}; 
+
+// Scheduler of activities inside one task. 
+class Loop{ 
+public: 
+	Loop() : Ready(nullptr), ReadyTail(nullptr), Waiting(nullptr), Alive(0) {}
+	Loop(const Loop &) = delete; 
+	Loop & operator=(const Loop &) = delete; 
+
+	// Take over an activity. Returns false if its frame could not be allocated. 
+	bool spawn(Act && A){ 
+		if(!A.H) return false; 
+		Act::promise_type & P = A.H.promise(); 
+		P.Owner = this; 
+		P.Node.Handle = A.H; 
+		P.Node.Kind = detail::Kind_Ready; 
+		A.H = nullptr; 
+		Alive++; 
+		push(&P.Node); 
+		return true; 
+	}
+
+	// Run all activities of this loop. Returns when every activity has finished. 
+	void run(){ 
+		while(Alive > 0){ 
+			poll(); 
+			if(Ready == nullptr){ 
+				sleep(); 
+				continue; 
+			}
+			detail::Wait * W = Ready; 	// Take a whole batch, activities readied meanwhile run next round. 
+			Ready = nullptr; 
+			ReadyTail = nullptr; 
+			while(W != nullptr){ 
+				detail::Wait * Next = W->Next; 
+				W->Handle.resume(); 
+				W = Next; 
+			}
+		}
+		OS_TBGstop(); 
+	}
+
+	// Internal: park an activity until its Wait node is satisfied. 
+	void park(detail::Wait * W){ 
+		W->Next = Waiting; 
+		Waiting = W; 
+	}
+
+private: 
+	detail::Wait * Ready; 
+	detail::Wait * ReadyTail; 
+	detail::Wait * Waiting; 
+	int Alive; 
+	friend struct Act::promise_type; 
+
+	void push(detail::Wait * W){ 
+		W->Kind = detail::Kind_Ready; 
+		W->Next = nullptr; 
+		if(ReadyTail == nullptr) Ready = W; 
+		else ReadyTail->Next = W; 
+		ReadyTail = W; 
+	}
+
+	// Move satisfied waiters onto the ready list. 
+	void poll(){ 
+		u32 MsgN = Lin_MsgQty(); 
+		detail::Wait ** Link = &Waiting; 
+		while(*Link != nullptr){ 
+			detail::Wait * W = *Link; 
+			int Go = 0; 
+			switch(W->Kind){ 
+				case detail::Kind_Delay: Go = (s32)(TickCount - W->Stamp) >= 0; break; 
+				case detail::Kind_Msg: 	if(MsgN > 0){ MsgN--; Go = 1; } break; 
+				case detail::Kind_Ev: 	Go = detail::EvFired(W); break; 
+			}
+			if(Go){ 
+				*Link = W->Next; 
+				push(W); 
+			}
+			else Link = &W->Next; 
+		}
+	}
+
+	// Nothing ready: arm TBG and Event List of the hosting task, then suspend. 
+	void sleep(){ 
+		TASK Self = Lin_GetCurrTask(); 
+		Lin_ECB * ECB = Self->ECB; 
+		int HasDelay = 0, EvN = 0; 
+		u32 Near = 0; 
+		for(detail::Wait * W = Waiting; W != nullptr; W = W->Next){ 
+			u32 Stamp; 
+			if(W->Kind == detail::Kind_Delay) Stamp = W->Stamp; 
+			else if(W->Kind == detail::Kind_Ev && EvN < Lin_EvListMax){ 
+				ECB->EvList[EvN++] = W->EvRef; 
+				continue; 
+			}
+			else if(W->Kind == detail::Kind_Ev) Stamp = TickCount + 1; 	// List full, poll it. 
+			else continue; 
+			if(HasDelay == 0 || (s32)(Stamp - Near) < 0) Near = Stamp; 
+			HasDelay = 1; 
+		}
+		if(HasDelay){ 
+			s32 Time = (s32)(Near - TickCount); 
+			OS_TBGdelay(Time > 0 ? Time : 0); 
+		}
+		else OS_TBGstop(); 
+		ECB->EvListSize = EvN; 
+		OS_Suspend(); 
+		ECB->EvListSize = 0; 
+		if(Self->WkupSrc != Src_Ev || *(int *)ECB->WkupRef == Ev_TypeBcst) return; 	// Broadcasts are left to poll. 
+		detail::Wait ** Link = &Waiting; 	// The scheduler consumed this event on our behalf. 
+		while(*Link != nullptr){ 
+			detail::Wait * W = *Link; 
+			if(W->Kind == detail::Kind_Ev && W->EvRef == ECB->WkupRef){ 
+				*Link = W->Next; 
+				push(W); 
+				return; 
+			}
+			Link = &W->Next; 
+		}
+	}
+}; 
+
+inline Act::promise_type::~promise_type(){ 
+	if(Owner != nullptr) Owner->Alive--; 
+}
+
+namespace detail { 
+
+// Common suspension for all awaitables below. 
+inline void Park(Act::Handle h, int Kind, u32 Stamp, void * EvRef){ 
+	Act::promise_type & P = h.promise(); 
+	P.Node.Kind = Kind; 
+	P.Node.Stamp = Stamp; 
+	P.Node.EvRef = EvRef; 
+	P.Owner->park(&P.Node); 
+}
+
+struct DelayAw{ 
+	u32 Time; 
+	bool await_ready() const noexcept { return false; }
+	void await_suspend(Act::Handle h) const noexcept { Park(h, Kind_Delay, TickCount + Time, nullptr); }
+	void await_resume() const noexcept {}
+}; 
+
+struct RecvAw{ 
+	bool await_ready() const noexcept { return Lin_MsgQty() > 0; }
+	void await_suspend(Act::Handle h) const noexcept { Park(h, Kind_Msg, 0, nullptr); }
+	MSG await_resume() const noexcept { return OS_RxMsg(); }
+}; 
+
+struct EvAw{ 
+	void * EvRef; 
+	bool await_ready() const noexcept { return !IsBcst(EvRef) && Ev_Query(EvRef) != 0; } 	// A broadcast needs a waiter first. 
+	void await_suspend(Act::Handle h) const noexcept { Park(h, Kind_Ev, IsBcst(EvRef) ? Ev_Epoch() : 0, EvRef); }
+	void await_resume() const noexcept {}
+}; 
+
+} // namespace detail 
+
+// Suspend this activity for Time ms. delay(0) lets the other activities run. 
+inline detail::DelayAw delay(u32 Time){ return detail::DelayAw{Time}; }
+// Receive the next message of the hosting task. 
+inline detail::RecvAw recv(void){ return detail::RecvAw{}; }
+// Wait for an event reference, with the same semantics as the ECB Event List. 
+inline detail::EvAw event(void * EvRef){ return detail::EvAw{EvRef}; }
+
+} // namespace os 
+
+#endif 
+
+// End of file. 
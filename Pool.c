@@ -0,0 +1,121 @@
+// Fixed Block Memory Pools version 0.1.0 
+/* Release Notes: 
+
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	A Pool hands out blocks of one size from storage reserved up front, 
+	either carved from the heap once by Pool_Create or supplied by the caller to Pool_Init. 
+	Alloc and Free only pop and push a free list inside a short critical region, 
+	so both take constant time, never fragment and may be called from ISRs. 
+
+	Heap backed: 
+		POOL Pool = Pool_Create(sizeof(Sample), 16); 
+	Static: 
+		static Pool_Blk SamplePool; 
+		static u32 SampleMem[Pool_MemSize(sizeof(Sample), 16) / 4]; 
+		Pool_Init(&SamplePool, SampleMem, sizeof(Sample), 16); 
+	Use: 
+		Sample * S = Pool_Alloc(Pool); 	// NULL when exhausted, counted in Fails. 
+		... 
+		Pool_Free(Pool, S); 
+
+	InUse, Peak and Fails are kept in the pool and may be read at any time. 
+	With Pool_Poison set, free blocks are filled with Pool_MagicFree and checked 
+	when handed out again, a broken fill is counted in Corrupt; 
+	allocated blocks start filled with Pool_MagicNew. 
+*/
+#include <OS.h> 
+
+#if Pool_Poison 
+static void Pool_Fill(void * Blk, u32 Size, u32 Magic){ 
+	u32 * Word = (u32 *)Blk; 
+	for(u32 i = 0; i < Size / 4; i++) Word[i] = Magic; 
+}
+static int Pool_Check(void * Blk, u32 Size){ 	// Skips the free list link. 
+	u32 * Word = (u32 *)Blk; 
+	for(u32 i = sizeof(Pool_FreeBlk) / 4; i < Size / 4; i++) if(Word[i] != Pool_MagicFree) return -1; 
+	return 0; 
+}
+#endif 
+
+POOL Pool_Create(u32 BlkSize, u32 BlkCnt){ 	// Create a pool and its blocks in one allocation. 
+	u32 Head = Pool_BlkSize(sizeof(Pool_Blk)); 
+	POOL Pool = (POOL)Lin_MemAlloc(Head + Pool_MemSize(BlkSize, BlkCnt)); 
+	if(Pool == NULL) return NULL; 
+	Pool_Init(Pool, (u8 *)Pool + Head, BlkSize, BlkCnt); 
+	Pool->Owned = 1; 
+	return Pool; 
+}
+
+void Pool_Init(POOL Pool, void * Mem, u32 BlkSize, u32 BlkCnt){ 	// Build a pool over Pool_MemSize(BlkSize, BlkCnt) Bytes of caller storage. 
+	Pool->BlkSize = Pool_BlkSize(BlkSize); 
+	Pool->BlkCnt = BlkCnt; 
+	Pool->Mem = (u8 *)Mem; 
+	Pool->Free = NULL; 
+	Pool->Owned = 0; 
+	Pool->InUse = 0; 
+	Pool_ClrStat(Pool); 
+	u8 * Blk = Pool->Mem + Pool->BlkSize * BlkCnt; 
+	while(Blk > Pool->Mem){ 	// Chained backwards so blocks go out in address order. 
+		Blk -= Pool->BlkSize; 
+#if Pool_Poison 
+		Pool_Fill(Blk, Pool->BlkSize, Pool_MagicFree); 
+#endif 
+		((Pool_FreeBlk *)Blk)->Next = Pool->Free; 
+		Pool->Free = (Pool_FreeBlk *)Blk; 
+	}
+}
+
+void Pool_Destroy(POOL Pool){ 	// Blocks still in use become invalid. Static storage is left to the caller. 
+	if(Pool->Owned) Lin_MemFree(Pool); 
+}
+
+void * Pool_Alloc(POOL Pool){ 	// Get a block. Returns NULL when the pool is exhausted. 
+	__critical_enter(); 
+	Pool_FreeBlk * Blk = Pool->Free; 
+	if(Blk == NULL){ 
+		Pool->Fails++; 
+		__critical_exit(); 
+		return NULL; 
+	}
+	Pool->Free = Blk->Next; 
+	if(++Pool->InUse > Pool->Peak) Pool->Peak = Pool->InUse; 
+#if Pool_Poison 
+	if(Pool_Check(Blk, Pool->BlkSize) != 0) Pool->Corrupt++; 
+#endif 
+	__critical_exit(); 
+#if Pool_Poison 
+	Pool_Fill(Blk, Pool->BlkSize, Pool_MagicNew); 
+#endif 
+	return Blk; 
+}
+
+void Pool_Free(POOL Pool, void * Mem){ 	// Give a block back. NULL is ignored. 
+	if(Mem == NULL) return; 
+	Pool_FreeBlk * Blk = (Pool_FreeBlk *)Mem; 
+#if Pool_Poison 
+	Pool_Fill(Blk, Pool->BlkSize, Pool_MagicFree); 
+#endif 
+	__critical_enter(); 
+	Blk->Next = Pool->Free; 
+	Pool->Free = Blk; 
+	Pool->InUse--; 
+	__critical_exit(); 
+}
+
+int Pool_Owns(POOL Pool, void * Mem){ 	// Whether Mem is a block of this pool. 
+	u32 Ofs = (u8 *)Mem - Pool->Mem; 
+	if((u8 *)Mem < Pool->Mem || Ofs >= Pool->BlkSize * Pool->BlkCnt) return 0; 
+	return Ofs % Pool->BlkSize == 0; 
+}
+
+void Pool_ClrStat(POOL Pool){ 	// Restart Peak from the current use, clear Fails and Corrupt. 
+	__critical_enter(); 
+	Pool->Peak = Pool->InUse; 
+	Pool->Fails = 0; 
+	Pool->Corrupt = 0; 
+	__critical_exit(); 
+}
+
+// End of file. 
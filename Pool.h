@@ -0,0 +1,43 @@
+// Fixed Block Memory Pools version 0.1.0 header file 
+#ifndef __Pool_H__ 
+#define __Pool_H__ 
+
+// Configuration 
+#define Pool_Poison 	0 					// Fill blocks on Alloc and Free to catch stale accesses 
+#define Pool_MagicFree 	0xDEADBEEF 	// Fill of a free block 
+#define Pool_MagicNew 	0xCDCDCDCD 	// Fill of a freshly allocated block 
+
+// Block size as laid out in a pool, and the storage a pool of BlkCnt blocks needs in Bytes. 
+#define Pool_BlkSize(size) 			(((size) + 7) & ~7) 
+#define Pool_MemSize(size, cnt) 	(Pool_BlkSize(size) * (cnt)) 
+
+// Free Block !!Internal 
+typedef struct Pool_FreeBlk{ 
+	struct Pool_FreeBlk * Next; 
+}Pool_FreeBlk; 
+
+// Pool Type - POOL 
+typedef struct Pool_Blk{ 
+	Pool_FreeBlk * Free; 
+	u8 * Mem; 			// First block 
+	u32 BlkSize; 		// Rounded up by Pool_BlkSize 
+	u32 BlkCnt; 
+	u32 InUse; 			// Blocks handed out now 
+	u32 Peak; 			// Most blocks ever handed out at once 
+	u32 Fails; 			// Allocations refused for lack of blocks 
+	u32 Corrupt; 		// Free blocks found written to, Pool_Poison only 
+	int Owned; 			// Storage comes from Pool_Create 
+}Pool_Blk, * POOL; 
+
+POOL   Pool_Create(u32 BlkSize, u32 BlkCnt); 
+void   Pool_Init(POOL Pool, void * Mem, u32 BlkSize, u32 BlkCnt); 
+void   Pool_Destroy(POOL Pool); 
+
+void * Pool_Alloc(POOL Pool); 
+void   Pool_Free(POOL Pool, void * Blk); 
+int    Pool_Owns(POOL Pool, void * Blk); 
+void   Pool_ClrStat(POOL Pool); 
+
+#endif 
+
+// End of file. 
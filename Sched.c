@@ -1,168 +1,342 @@
-// Symmetrical Scheduling Core version 0.2.1  
-/* Release Notes: 
-
-		<0.2.1 > 190208 Changed SpinLock Behavior. 
-		<0.2.0 > 190208 Added another type of suspend requests. 
-		<0.1.2 > 190206 Added debug info: scheduled times. 
-		<0.1.1 > 190203 Fully Commented. 
-		<0.1.0 > 190203 Initial Release. 
-*/
-#include <Lin.h> 
-#include "Lint.h" 
-#include "Sched.h" 
-
-u32 PrevSysTime; 	// Timestamp of last scheduling. For determining when to perform TimeSlice operations. 
-TASK Running; 		// Currently Running Task. (Different from Lin_CurrTask for it changes to the scheduler thread itself when scheduling. ) 
-int SpinLock; 		// SpinLock flag. Locked when > 0. 
-u32 Sched_DebugSchedTimes; 
-
-void Sched_Init(TASK MainTask){ 	// Initialization of the scheduler and main task. 
-	PrevSysTime = 0xFFFFFFFF; 
-	Running = NULL; 
-	SpinLock = 0; 
-	Sched_DebugSchedTimes = 0; 
-	Lint_Init(MainTask); 
-}
-int Sched_Reg(TASK Task){ 	// Register for a task. Puts it in the Standby List so you might need a GenericEvent to wake it up. 
-	__critical_enter(); 
-	if(!Lint_IsDead(Task)){ 
-		__critical_exit(); 
-		return -1; 
-	}
-	DL_Add(Task); 
-	__critical_exit(); 
-	return 0; 
-}
-int Sched_UnReg(TASK Task){ 	// Unregister for a task. Removes it from all lists. 
-	__critical_enter(); 
-	if(Lint_IsDead(Task)){ 
-		__critical_exit(); 
-		return -1; 
-	}
-	if(Lint_IsNotWaiting(Task)) DL_Del(Task); 
-	else PQ_Del(Task); 
-	__critical_exit(); 
-	return 0; 
-}
-void Sched_Lock(void){ 	// Apply SpinLock. 
-	__critical_enter(); 
-	SpinLock++; 
-	__critical_exit(); 
-}
-void Sched_UnLock(void){ 	// Release SpinLock. 
-	__critical_enter(); 
-	SpinLock--; 
-	__critical_exit(); 
-}
-void Sched_ClrLock(void){ // Force Release SpinLock. 
-//__critical_enter(); 
-	SpinLock = 0; 
-//__critical_exit(); 
-}
-
-
-int DoEventCheck(TASK Task, u32 SysTime, int (*EvQuery)(void * EvRef), int isPreChk); // Checking Events for a Task. 
-int TimeSliceTick(TASK Task); // Updating and checking TimeSlices for a Task. 
-
-TASK Sched_Do(u32 SysTime, int (*EvQuery)(void * EvRef), void (*EvCycle)(void), int (*GetSus)(TASK *)){ // Pick Next Task 
-	// SysTime is the current ms SystemTick Time. 
-	// EvQuery is for polling events. Return 0 if not found and non-zero if found. 
-	// EvCycle is for marking a mass-receiving cycle. See the Biomimetic Event System for details. 
-	// GetSus fetch tasks who suspended themselves by requests, and return whether they force themselves to woke up directly. 
-	TASK Task = DL_Trav(NULL); 
-	while(Task != NULL){ 	// I. Traverse through Standby List. 
-		TASK NextTask = DL_Trav(Task); 
-		if(DoEventCheck(Task, SysTime, EvQuery, 0)){ 
-			DL_Del(Task); // Move from Stdby to Waiting 
-			PQ_Add(Task); 
-		}
-		Task = NextTask; 
-	}
-	for(int force= GetSus(&Task); Task != NULL; force = GetSus(&Task)){ // II. Those who suspended themselves or requesting yield. 
-		if(Lint_IsNotWaiting(Task)) continue; 
-		if(force || DoEventCheck(Task, SysTime, EvQuery, 1)) PQ_Rot(Task); // Force wake up directly or previously happened event 
-		else{ 
-			PQ_Del(Task); // Does need waiting 
-			DL_Add(Task); 
-		}
-	}
-	EvCycle(); // Symmetrical Scheduling Done. 
-	if((Running != NULL) && (Lint_IsDead(Running) == 0)){ 	// Previous Cycle CPU Not Idle and Running is stil Living 
-		if(SysTime != PrevSysTime) 														// If SysTick Increaced 
-			if(TimeSliceTick(Running)) 													// Apply Time Slice Cost and Check Time Balance 
-				if(!Lint_IsNotWaiting(Running)) PQ_Rot(Running); 	// If Time is up and Still in Waiting List, Rotate. 
-	}
-	if((Running == NULL) || (Lint_IsNotWaiting(Running))) SpinLock = 0; 	// If Previous Cycle CPU Idle or Running leaves Waiting List, Release SpinLock. 
-	PrevSysTime = SysTime; 
-	if(SpinLock <= 0){ 			// If SpinLock inactive 
-		SpinLock = 0; 
-		Running = PQ_Get(); 	// Get Next 
-	}
-	Sched_DebugSchedTimes++; 
-	return Running; 
-}
-
-// Internal Functions 
-int DoEventCheck(TASK Task, u32 SysTime, int (*EvQuery)(void * EvRef), int isPreChk){ 	// Checking Events for a Task. 
-	int EvActive = 0; 
-	
-	// I. Generic Event Flag Check 
-	if(Task->GenEvFlag != 0){ 	
-		Task->GenEvFlag = 0; 
-		if(EvActive == 0){ 
-			EvActive = 1; 
-			Task->WkupSrc = Src_Gen; 
-		}
-	}
-	
-	// II. Time Base Generator Check 
-	Lin_ECB * ECB = Task->ECB; 
-	u32 Tstamp = ECB->TimeBase_Stamp; 
-	int Tmode = ECB->TimeBase_Mode; // Turn off TBG when mode < 0 
-	if(Tstamp <= SysTime && Tmode >= 0){ 
-		if(Tmode == 0) ECB->TimeBase_Mode = -1; // One-shot when mode = 0 
-		else ECB->TimeBase_Stamp = Tmode + SysTime; // Continous when mode > 0, interval determinated by the value of mode. 
-		if(EvActive == 0){ // TBG still works even GEF activates, for TBG is an individual block, although the event production and identification codes are written together here. 
-			EvActive = 1; 
-			Task->WkupSrc = Src_TBG; 
-		}
-	}
-	
-	// III. Event List Check 
-	if(EvActive == 0){ // No need traversing the list if previously something activated the process. 
-		void ** EvList = ECB->EvList; 
-		int EvListN = ECB->EvListSize; 
-		for(int i = 0; i < EvListN; i++){ 	
-			void * CurrEv = EvList[i]; 
-			if(EvQuery(CurrEv)){ 
-				EvActive = 1; 
-				Task->WkupSrc = Src_Ev; 
-				ECB->WkupRef = CurrEv; 
-				break; 
-			}
-		}
-	}
-	
-	// Wakeup Method and Sources 
-	if(EvActive != 0){ 
-		if(isPreChk) Task->WkupMeth = Meth_Prev; 
-		else Task->WkupMeth = Meth_Wait; 
-	}
-	else{ 
-		Task->WkupMeth = Meth_None; 
-		Task->WkupSrc = Src_None; 
-	}
-	
-	return EvActive; 
-}
-
-int TimeSliceTick(TASK Task){ 	// Update and check TimeSlice. 
-	if(Task->TimeSliceReload <= 0) return 0; 
-	if(--Task->TimeSliceCounter <= 0){ 
-		Task->TimeSliceCounter = Task->TimeSliceReload; 
-		return 1; 
-	}
-	return 0; 
-}
-
-// End of file. 
+// Symmetrical Scheduling Core version 0.7.1 
+/* Release Notes: 
+
+		<0.7.1 > 261019 HistPct returns 0 for an empty histogram and the bucket of the worst sample at 100. 
+										Added Pct for histograms of any length. Under SIM run starts are stamped in virtual time alone. 
+		<0.7.0 > 261019 Back to a single scheduler context. Stealing, affinity and the per-core contexts are removed, 
+										no port ever switched tasks on a second core. Added IsLocked and SetRunning for direct handoffs. 
+		<0.6.2 > 261019 Documented what multi-core support covers. 
+		<0.6.1 > 261019 Debug counters updated through Met_Inc. 
+		<0.6.0 > 261019 Optional per-task histograms of TBG release latency and response time. 
+		<0.5.0 > 261019 One scheduler context per core. Idle cores steal waiting tasks from the others, within their affinity. 
+		<0.4.0 > 261019 Added TickCheck: the tick ISR counts down time slices and only requests a pass when one is due. 
+		<0.3.0 > 261019 TBG stamps in microseconds, compared wrap-safely. Periodic TBG no longer drifts. 
+										Tracks the earliest TBG stamp in the Standby List for the timebase. 
+		<0.2.1 > 190208 Changed SpinLock Behavior. 
+		<0.2.0 > 190208 Added another type of suspend requests. 
+		<0.1.2 > 190206 Added debug info: scheduled times. 
+		<0.1.1 > 190203 Fully Commented. 
+		<0.1.0 > 190203 Initial Release. 
+*/
+#include <Lin.h> 
+#include "Lint.h" 
+#include "Sched.h" 
+
+u32 PrevSysTime; 	// Timestamp of last scheduling. For determining when to perform TimeSlice operations. 
+TASK Running; 		// Currently Running Task. (Different from Lin_CurrTask for it changes to the scheduler thread itself when scheduling. ) 
+int SpinLock; 		// SpinLock flag. Locked when > 0. 
+u32 Sched_DebugSchedTimes; 
+u32 Sched_NextStamp; 	// Earliest TBG stamp in the Standby List after the last pass. 
+int Sched_NextValid; 	// Is Sched_NextStamp valid? 
+volatile int Sched_WakeReq; 	// Set by anything that may ready a task, cleared by each pass. 
+int Sched_SliceUp; 		// Running used up its TimeSlice and has peers to rotate with. 
+int Sched_SkipTicks; 	// Ticks since the last pass. 
+u32 Sched_DebugTickSkips; 
+
+void Sched_Init(TASK MainTask){ 	// Initialization of the scheduler and main task. 
+	PrevSysTime = 0xFFFFFFFF; 
+	Running = NULL; 
+	SpinLock = 0; 
+	Sched_DebugSchedTimes = 0; 
+	Sched_NextStamp = 0; 
+	Sched_NextValid = 0; 
+	Sched_WakeReq = 1; 
+	Sched_SliceUp = 0; 
+	Sched_SkipTicks = 0; 
+	Sched_DebugTickSkips = 0; 
+	Lint_Init(MainTask); 
+}
+int Sched_Reg(TASK Task){ 	// Register for a task. Puts it in the Standby List so you might need a GenericEvent to wake it up. 
+	__critical_enter(); 
+	if(!Lint_IsDead(Task)){ 
+		__critical_exit(); 
+		return -1; 
+	}
+	DL_Add(Task); 
+	__critical_exit(); 
+	return 0; 
+}
+int Sched_UnReg(TASK Task){ 	// Unregister for a task. Removes it from all lists. 
+	__critical_enter(); 
+	if(Lint_IsDead(Task)){ 
+		__critical_exit(); 
+		return -1; 
+	}
+	if(Lint_IsNotWaiting(Task)) DL_Del(Task); 
+	else PQ_Del(Task); 
+	if(Task == Running) Running = NULL; 	// The tick ISR must not touch it any more. 
+	__critical_exit(); 
+	return 0; 
+}
+void Sched_Lock(void){ 	// Apply SpinLock. 
+	__critical_enter(); 
+	SpinLock++; 
+	__critical_exit(); 
+}
+void Sched_UnLock(void){ 	// Release SpinLock. 
+	__critical_enter(); 
+	SpinLock--; 
+	__critical_exit(); 
+}
+void Sched_ClrLock(void){ // Force Release SpinLock. 
+//__critical_enter(); 
+	SpinLock = 0; 
+//__critical_exit(); 
+}
+int Sched_IsLocked(void){ 	// Is the SpinLock held? 
+	return SpinLock > 0; 
+}
+void Sched_SetRunning(TASK Task){ 	// Task was switched to outside a pass, e.g. by a direct handoff. In a critical region. 
+	Running = Task; 
+}
+
+
+int DoEventCheck(TASK Task, u32 TimeUs, int (*EvQuery)(void * EvRef), int isPreChk); // Checking Events for a Task. 
+int TimeSliceTick(TASK Task); // Updating and checking TimeSlices for a Task. 
+void TrackTBG(TASK Task); // Tracking the earliest TBG stamp in the Standby List. 
+void HistRelease(Lin_ECB * ECB, u32 Release, u32 TimeUs); // Histograms: a TBG release. 
+void HistStart(TASK Task, u32 TimeUs); // Histograms: first run after a release. 
+void HistDone(TASK Task, u32 TimeUs); // Histograms: suspended again. 
+
+TASK Sched_Do(u32 SysTime, u32 TimeUs, int (*EvQuery)(void * EvRef), void (*EvCycle)(void), int (*GetSus)(TASK *)){ // Pick Next Task 
+	// SysTime is the current ms SystemTick Time. 
+	// TimeUs is the current us Time, low 32 bits, for the Time Base Generators. 
+	// EvQuery is for polling events. Return 0 if not found and non-zero if found. 
+	// EvCycle is for marking a mass-receiving cycle. See the Biomimetic Event System for details. 
+	// GetSus fetch tasks who suspended themselves by requests, and return whether they force themselves to woke up directly. 
+#if Sched_HistEn && !defined(SIM) 
+	u32 Cyc = Lin_CycCnt(); 
+#endif 
+	Sched_WakeReq = 0; 	// Wake ups from now on are seen by this pass or request the next one. 
+	Sched_SkipTicks = 0; 
+	Sched_NextValid = 0; 
+	TASK Task = DL_Trav(NULL); 
+	while(Task != NULL){ 	// I. Traverse through Standby List. 
+		TASK NextTask = DL_Trav(Task); 
+		if(DoEventCheck(Task, TimeUs, EvQuery, 0)){ 
+			DL_Del(Task); // Move from Stdby to Waiting 
+			PQ_Add(Task); 
+		}
+		else TrackTBG(Task); 
+		Task = NextTask; 
+	}
+	for(int force= GetSus(&Task); Task != NULL; force = GetSus(&Task)){ // II. Those who suspended themselves or requesting yield. 
+		if(Lint_IsNotWaiting(Task)) continue; 
+#if Sched_HistEn 
+		if(!force) HistDone(Task, TimeUs); 
+#endif 
+		if(force || DoEventCheck(Task, TimeUs, EvQuery, 1)) PQ_Rot(Task); // Force wake up directly or previously happened event 
+		else{ 
+			PQ_Del(Task); // Does need waiting 
+			DL_Add(Task); 
+			TrackTBG(Task); 
+		}
+	}
+	EvCycle(); // Symmetrical Scheduling Done. 
+#if Sched_FastTick 
+	if(Sched_SliceUp){ 	// Time Slices are counted by Sched_TickCheck. 
+		Sched_SliceUp = 0; 
+		if((Running != NULL) && (Lint_IsDead(Running) == 0) && !Lint_IsNotWaiting(Running)) PQ_Rot(Running); 
+	}
+#else 
+	if((Running != NULL) && (Lint_IsDead(Running) == 0)){ 	// Previous Cycle CPU Not Idle and Running is stil Living 
+		if(SysTime != PrevSysTime) 														// If SysTick Increaced 
+			if(TimeSliceTick(Running)) 													// Apply Time Slice Cost and Check Time Balance 
+				if(!Lint_IsNotWaiting(Running)) PQ_Rot(Running); 	// If Time is up and Still in Waiting List, Rotate. 
+	}
+#endif 
+	if((Running == NULL) || (Lint_IsNotWaiting(Running))) SpinLock = 0; 	// If Previous Cycle CPU Idle or Running leaves Waiting List, Release SpinLock. 
+	PrevSysTime = SysTime; 
+	if(SpinLock <= 0){ 			// If SpinLock inactive 
+		SpinLock = 0; 
+		Running = PQ_Get(); 	// Get Next 
+	}
+#if Sched_HistEn && defined(SIM) 
+	if(Running != NULL) HistStart(Running, TimeUs); 	// Virtual time, the cycle counter runs on wall time. 
+#elif Sched_HistEn 
+	if(Running != NULL) HistStart(Running, TimeUs + (Lin_CycCnt() - Cyc) / (SystemCoreClock / 1000000)); 
+#endif 
+	Met_Inc(Sched_DebugSchedTimes); 
+	return Running; 
+}
+
+int Sched_TickCheck(u32 TimeUs){ 	// Called by the tick ISR instead of yielding every tick. Returns non-zero when a pass is due. 
+	// A pass is due when something may have readied a task, a TBG stamp in the Standby List has passed, 
+	// or Running used up its TimeSlice while other tasks of its priority are waiting. 
+	// Events only found by polling are seen within Sched_PollTicks ticks. 
+	int Due = Sched_WakeReq; 
+	if(Sched_NextValid && (s32)(TimeUs - Sched_NextStamp) >= 0) Due = 1; 
+	TASK Task = Running; 
+	if((Task != NULL) && TimeSliceTick(Task)){ 
+		if(!Lint_IsNotWaiting(Task) && Task->RBN != Task){ 	// Rotating alone changes nothing. 
+			Sched_SliceUp = 1; 
+			Due = 1; 
+		}
+	}
+	if(++Sched_SkipTicks >= Sched_PollTicks) Due = 1; 
+	if(Due == 0) Met_Inc(Sched_DebugTickSkips); 
+	return Due; 
+}
+
+// Internal Functions 
+int DoEventCheck(TASK Task, u32 TimeUs, int (*EvQuery)(void * EvRef), int isPreChk){ 	// Checking Events for a Task. 
+	int EvActive = 0; 
+	
+	// I. Generic Event Flag Check 
+	if(Task->GenEvFlag != 0){ 	
+		Task->GenEvFlag = 0; 
+		if(EvActive == 0){ 
+			EvActive = 1; 
+			Task->WkupSrc = Src_Gen; 
+		}
+	}
+	
+	// II. Time Base Generator Check 
+	Lin_ECB * ECB = Task->ECB; 
+	u32 Tstamp = ECB->TimeBase_Stamp; 
+	int Tmode = ECB->TimeBase_Mode; // Turn off TBG when mode < 0 
+	if(Tmode >= 0 && (s32)(TimeUs - Tstamp) >= 0){ // Stamps are in us and wrap, compare the difference. 
+#if Sched_HistEn 
+		HistRelease(ECB, Tstamp, TimeUs); 
+#endif 
+		if(Tmode == 0) ECB->TimeBase_Mode = -1; // One-shot when mode = 0 
+		else{ // Continous when mode > 0, interval determinated by the value of mode. 
+			Tstamp += Tmode; // Keep the phase, unless periods were missed entirely. 
+			if((s32)(TimeUs - Tstamp) >= 0) Tstamp = TimeUs + Tmode; 
+			ECB->TimeBase_Stamp = Tstamp; 
+		}
+		if(EvActive == 0){ // TBG still works even GEF activates, for TBG is an individual block, although the event production and identification codes are written together here. 
+			EvActive = 1; 
+			Task->WkupSrc = Src_TBG; 
+		}
+	}
+	
+	// III. Event List Check 
+	if(EvActive == 0){ // No need traversing the list if previously something activated the process. 
+		void ** EvList = ECB->EvList; 
+		int EvListN = ECB->EvListSize; 
+		for(int i = 0; i < EvListN; i++){ 	
+			void * CurrEv = EvList[i]; 
+			if(EvQuery(CurrEv)){ 
+				EvActive = 1; 
+				Task->WkupSrc = Src_Ev; 
+				ECB->WkupRef = CurrEv; 
+				break; 
+			}
+		}
+	}
+	
+	// Wakeup Method and Sources 
+	if(EvActive != 0){ 
+		if(isPreChk) Task->WkupMeth = Meth_Prev; 
+		else Task->WkupMeth = Meth_Wait; 
+	}
+	else{ 
+		Task->WkupMeth = Meth_None; 
+		Task->WkupSrc = Src_None; 
+	}
+	
+	return EvActive; 
+}
+
+void TrackTBG(TASK Task){ 	// Track the earliest TBG stamp among tasks left in the Standby List. 
+	Lin_ECB * ECB = Task->ECB; 
+	if(ECB->TimeBase_Mode < 0) return; 
+	if(Sched_NextValid == 0 || (s32)(ECB->TimeBase_Stamp - Sched_NextStamp) < 0) Sched_NextStamp = ECB->TimeBase_Stamp; 
+	Sched_NextValid = 1; 
+}
+
+/* Histograms: 
+	A task with a Sched_HistBlk attached records, for each TBG release, 
+	the latency from its stamp to the first run and the response time from its stamp 
+	until the task suspends again, both in us, in log2 buckets. 
+	The run starts are taken when the scheduler picks the task, refined by the cycle counter, 
+	or at the virtual time of the pass under SIM. 
+*/
+static int HistBucket(u32 Us){ 	// Bucket n holds [2^(n-1), 2^n) us. 
+	int n = 0; 
+	while(Us != 0 && n < Sched_HistBuckets - 1){ 
+		Us >>= 1; 
+		n++; 
+	}
+	return n; 
+}
+
+void HistRelease(Lin_ECB * ECB, u32 Release, u32 TimeUs){ 
+	Sched_HistBlk * Hist = (Sched_HistBlk *)ECB->Hist; 
+	if(Hist == NULL) return; 
+	if(Hist->State == Sched_HistRun){ 	// Overran into this release, close the last one here. 
+		u32 Resp = TimeUs - Hist->Release; 
+		Hist->Resp[HistBucket(Resp)]++; 
+		if(Resp > Hist->RespMax) Hist->RespMax = Resp; 
+	}
+	Hist->Release = Release; 
+	Hist->State = Sched_HistReady; 
+}
+
+void HistStart(TASK Task, u32 TimeUs){ 
+	Sched_HistBlk * Hist = (Sched_HistBlk *)Task->ECB->Hist; 
+	if(Hist == NULL || Hist->State != Sched_HistReady) return; 
+	u32 Lat = TimeUs - Hist->Release; 
+	if((s32)Lat < 0) Lat = 0; 
+	Hist->Lat[HistBucket(Lat)]++; 
+	if(Lat > Hist->LatMax) Hist->LatMax = Lat; 
+	Hist->Count++; 
+	Hist->State = Sched_HistRun; 
+}
+
+void HistDone(TASK Task, u32 TimeUs){ 
+	Sched_HistBlk * Hist = (Sched_HistBlk *)Task->ECB->Hist; 
+	if(Hist == NULL || Hist->State != Sched_HistRun) return; 
+	u32 Resp = TimeUs - Hist->Release; 
+	Hist->Resp[HistBucket(Resp)]++; 
+	if(Resp > Hist->RespMax) Hist->RespMax = Resp; 
+	Hist->State = Sched_HistIdle; 
+}
+
+void Sched_HistAttach(TASK Task, Sched_HistBlk * Hist){ 	// Start recording a task into Hist, NULL to stop. 
+	if(Hist != NULL) Sched_HistClr(Hist); 
+	Task->ECB->Hist = Hist; 
+}
+
+void Sched_HistClr(Sched_HistBlk * Hist){ 	// Reset all counts. 
+	__critical_enter(); 
+	for(int i = 0; i < Sched_HistBuckets; i++){ 
+		Hist->Lat[i] = 0; 
+		Hist->Resp[i] = 0; 
+	}
+	Hist->LatMax = 0; 
+	Hist->RespMax = 0; 
+	Hist->Count = 0; 
+	Hist->State = Sched_HistIdle; 
+	__critical_exit(); 
+}
+
+u32 Sched_HistPct(const u32 * Bucket, int Pct){ 	// Upper bound in us of the bucket holding the percentile, of Hist->Lat or Hist->Resp. 
+	return Sched_Pct(Bucket, Sched_HistBuckets, Pct); 
+}
+
+u32 Sched_Pct(const u32 * Bucket, int N, int Pct){ 	// Same for N log2 buckets, bucket n holding [2^(n-1), 2^n). 0 when empty. 
+	u32 Total = 0; 
+	for(int i = 0; i < N; i++) Total += Bucket[i]; 
+	if(Total == 0) return 0; 
+	if(Pct < 0) Pct = 0; 
+	u32 Need = ((unsigned long long)Total * Pct + 99) / 100; 	// Rank of the sample, 1 for the best and Total for the worst. 
+	if(Need < 1) Need = 1; 
+	if(Need > Total) Need = Total; 
+	u32 Cnt = 0; 
+	int b = 0; 
+	while(b < N - 1 && Cnt + Bucket[b] < Need) Cnt += Bucket[b++]; 
+	return 1u << b; 
+}
+
+int TimeSliceTick(TASK Task){ 	// Update and check TimeSlice. 
+	if(Task->TimeSliceReload <= 0) return 0; 
+	if(--Task->TimeSliceCounter <= 0){ 
+		Task->TimeSliceCounter = Task->TimeSliceReload; 
+		return 1; 
+	}
+	return 0; 
+}
+
+// End of file. 
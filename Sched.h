@@ -1,25 +1,62 @@
-// Symmetrical Scheduling Core version 0.2.1 header file 
-#ifndef __Sched_H__ 
-#define __Sched_H__ 
-
-void Sched_Init(TASK MainTask); 
-
-int  Sched_Reg(TASK Task); 
-int  Sched_UnReg(TASK Task); 
-
-void Sched_Lock(void); 
-void Sched_UnLock(void); 
-void Sched_ClrLock(void); 
-
-TASK Sched_Do(u32 SysTime, int (*EvQuery)(void * EvRef), void (*EvCycle)(void), int (*GetSuspended)(TASK *)); 
-
-#define Meth_None 0 // Standby. 
-#define Meth_Wait 1 // Woke up from standby list. 
-#define Meth_Prev 2 // Woke up from previously existed event, not experiencing suspention. 
-
-#define Src_Ev    1 // Event from Event References in List. 
-#define Src_None  0 // Has no Event. 
-#define Src_Gen  -1 // Event from Generic Event Flag. 
-#define Src_TBG  -2 // Event from Time Base Generator. 
-
-#endif 
+// Symmetrical Scheduling Core version 0.7.1 header file 
+#ifndef __Sched_H__ 
+#define __Sched_H__ 
+
+// Configuration 
+#define Sched_FastTick 	1 		// The tick ISR decides whether a pass is due, see Sched_TickCheck 
+#define Sched_PollTicks 	16 		// Most ticks skipped in a row, bounds the latency of polled events 
+#define Sched_IdlePri 	0x7FFFFFFF 	// Priority of idle tasks 
+#define Sched_HistEn 	1 		// Record release latency and response time of tasks with a histogram attached 
+#define Sched_HistBuckets 	20 	// Bucket n holds [2^(n-1), 2^n) us 
+
+#define Sched_HistIdle 	0 	// Waiting for a TBG release 
+#define Sched_HistReady 	1 	// Released, not run yet 
+#define Sched_HistRun 	2 	// Running on a release 
+
+// Release Histogram of a task 
+typedef struct Sched_HistBlk{ 
+	u32 Lat[Sched_HistBuckets]; 	// Release latency: TBG stamp to first run 
+	u32 Resp[Sched_HistBuckets]; 	// Response time: TBG stamp to suspension 
+	u32 LatMax; 
+	u32 RespMax; 
+	u32 Count; 					// Releases run 
+	u32 Release; 				// Stamp of the current release 
+	int State; 
+}Sched_HistBlk; 
+
+void Sched_HistAttach(TASK Task, Sched_HistBlk * Hist); 
+void Sched_HistClr(Sched_HistBlk * Hist); 
+u32  Sched_HistPct(const u32 * Bucket, int Pct); 
+u32  Sched_Pct(const u32 * Bucket, int N, int Pct); 
+
+void Sched_Init(TASK MainTask); 
+
+int  Sched_Reg(TASK Task); 
+int  Sched_UnReg(TASK Task); 
+
+void Sched_Lock(void); 
+void Sched_UnLock(void); 
+void Sched_ClrLock(void); 
+
+TASK Sched_Do(u32 SysTime, u32 TimeUs, int (*EvQuery)(void * EvRef), void (*EvCycle)(void), int (*GetSuspended)(TASK *)); 
+
+extern u32 Sched_NextStamp; 	// Earliest TBG stamp in the Standby List after the last pass 
+extern int Sched_NextValid; 	// Is there any? 
+
+int  Sched_TickCheck(u32 TimeUs); 
+extern volatile int Sched_WakeReq; 	// A task may have become ready since the last pass 
+#define Sched_Wake() (Sched_WakeReq = 1) 
+
+int  Sched_IsLocked(void); 
+void Sched_SetRunning(TASK Task); 
+
+#define Meth_None 0 // Standby. 
+#define Meth_Wait 1 // Woke up from standby list. 
+#define Meth_Prev 2 // Woke up from previously existed event, not experiencing suspention. 
+
+#define Src_Ev    1 // Event from Event References in List. 
+#define Src_None  0 // Has no Event. 
+#define Src_Gen  -1 // Event from Generic Event Flag. 
+#define Src_TBG  -2 // Event from Time Base Generator. 
+
+#endif 
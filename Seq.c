@@ -0,0 +1,96 @@
+// Published State version 0.1.1 
+/* Release Notes: 
+
+		<0.1.1 > 261019 Retries counts with a plain increment, independent of Met_Enable. 
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	A SEQ holds a snapshot of Size Bytes, e.g. a sensor sample, published by one writer 
+	and read by any number of tasks or ISRs. Neither side masks interrupts or blocks. 
+
+	The snapshot is kept twice. The writer fills the copy not being read, then flips 
+	the sequence, so a reader copying the current one is only disturbed when the writer 
+	comes back to that copy two publishes later. The reader checks the sequence before 
+	and after its copy and starts over in that case, which needs a writer faster than 
+	one publish per half a read and never happens at ordinary sample rates. 
+
+	Writer, e.g. in an ADC ISR: 
+		Sample S = {ADC1->DR, TIM2->CNT}; 
+		Seq_Write(Snap, &S); 
+	or in place, starting from the last snapshot: 
+		Sample * S = (Sample *)Seq_WritePtr(Snap); 
+		S->Raw = ADC1->DR; 
+		Seq_Commit(Snap); 
+	Reader: 
+		Sample S; 
+		u32 Version = Seq_Read(Snap, &S); 	// Compare with the last Version to spot new data. 
+
+	Writers must not preempt each other on the same SEQ. Bench_Seq compares the cost 
+	against reading under a critical region. 
+*/
+#include <OS.h> 
+
+SEQ Seq_Create(u32 Size){ 	// Create a published state and both copies in one allocation. 
+	SEQ Seq = (SEQ)Lin_MemAlloc(((sizeof(Seq_Blk) + 7) & ~7) + 2 * Size); 
+	if(Seq == NULL) return NULL; 
+	Seq_Init(Seq, (u8 *)Seq + ((sizeof(Seq_Blk) + 7) & ~7), Size); 
+	Seq->Owned = 1; 
+	return Seq; 
+}
+
+void Seq_Init(SEQ Seq, void * Buf, u32 Size){ 	// Build a published state over 2 * Size caller supplied Bytes, zeroed. 
+	Seq->Buf = (u8 *)Buf; 
+	Seq->Size = Size; 
+	Seq->Seq = 0; 
+	Seq->Retries = 0; 
+	Seq->Owned = 0; 
+	for(u32 i = 0; i < 2 * Size; i++) Seq->Buf[i] = 0; 
+}
+
+void Seq_Destroy(SEQ Seq){ 
+	if(Seq->Owned) Lin_MemFree(Seq); 
+}
+
+static void Seq_Copy(u8 * Dst, const u8 * Src, u32 Size){ 
+	if((((u32)Dst | (u32)Src | Size) & 3) == 0){ 	// Word aligned, the usual case for structs. 
+		for(u32 i = 0; i < Size; i += 4) *(u32 *)(Dst + i) = *(const u32 *)(Src + i); 
+		return; 
+	}
+	for(u32 i = 0; i < Size; i++) Dst[i] = Src[i]; 
+}
+
+void * Seq_WritePtr(SEQ Seq){ 	// Open the spare copy, filled with the current snapshot. Seq_Commit publishes it. 
+	u32 Cur = Seq->Seq; 
+	Seq->Seq = Cur + 1; 	// Odd: the spare copy is being written. 
+	__dmb(0xF); 
+	u8 * Spare = Seq->Buf + (((Cur >> 1) + 1) & 1) * Seq->Size; 
+	Seq_Copy(Spare, Seq->Buf + ((Cur >> 1) & 1) * Seq->Size, Seq->Size); 
+	return Spare; 
+}
+
+void Seq_Commit(SEQ Seq){ 
+	__dmb(0xF); 
+	Seq->Seq = Seq->Seq + 1; 	// Even again, the spare copy is current. 
+}
+
+void Seq_Write(SEQ Seq, const void * Data){ 	// Publish a whole snapshot. 
+	u32 Cur = Seq->Seq; 
+	Seq->Seq = Cur + 1; 
+	__dmb(0xF); 
+	Seq_Copy(Seq->Buf + (((Cur >> 1) + 1) & 1) * Seq->Size, (const u8 *)Data, Seq->Size); 
+	__dmb(0xF); 
+	Seq->Seq = Cur + 2; 
+}
+
+u32 Seq_Read(SEQ Seq, void * Data){ 	// Copy out a consistent snapshot. Returns its version. 
+	for(;;){ 
+		u32 Start = Seq->Seq & ~1; 	// Last completed publish, a write in progress goes to the other copy. 
+		__dmb(0xF); 
+		Seq_Copy((u8 *)Data, Seq->Buf + ((Start >> 1) & 1) * Seq->Size, Seq->Size); 
+		__dmb(0xF); 
+		if(Seq->Seq - Start < 3) return Start >> 1; 	// The writer has not come back to our copy. 
+		Seq->Retries++; 	// Statistics only, a lost update between readers is harmless. 
+	}
+}
+
+// End of file. 
@@ -0,0 +1,30 @@
+// Published State version 0.1.1 header file 
+#ifndef __Seq_H__ 
+#define __Seq_H__ 
+
+// Published State Type - SEQ 
+typedef struct Seq_Blk{ 
+	u8 * Buf; 				// Two copies of Size Bytes 
+	u32 Size; 
+	volatile u32 Seq; 		// Twice the publishes, odd while one is being written 
+	u32 Retries; 			// Reads that had to start over 
+	int Owned; 				// Buffer comes from Seq_Create 
+}Seq_Blk, * SEQ; 
+
+SEQ    Seq_Create(u32 Size); 
+void   Seq_Init(SEQ Seq, void * Buf, u32 Size); 
+void   Seq_Destroy(SEQ Seq); 
+
+// Writer side, ISR safe, one writer at a time 
+void   Seq_Write(SEQ Seq, const void * Data); 
+void * Seq_WritePtr(SEQ Seq); 
+void   Seq_Commit(SEQ Seq); 
+
+// Reader side, any number of readers, ISR safe 
+u32    Seq_Read(SEQ Seq, void * Data); 
+
+#define Seq_Version(seq) ((seq)->Seq >> 1) 	// Publishes so far 
+
+#endif 
+
+// End of file. 
@@ -0,0 +1,171 @@
+// Byte Stream Buffers version 0.1.1 
+/* Release Notes: 
+
+		<0.1.1 > 261019 Wait keeps one deadline, a reader woken below Trigger no longer restarts its Timeout. 
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	A Stream carries bytes from one writer, usually an ISR, to one reader task 
+	through a ring of Size Bytes, Size being a power of 2. 
+	Each side only advances its own index, so neither side takes a lock 
+	and no carrier is allocated per chunk. 
+	The reader is woken with a Generic Event once Trigger Bytes are buffered. 
+
+	Writer, byte or chunk at a time: 
+		void USART1_IRQHandler(void){ 
+			u8 Byte = USART1->DR; 
+			Strm_Write(Rx, &Byte, 1); 
+		}
+	Writer, DMA in circular mode over the whole ring: 
+		DMA is set up once on Rx->Buf with Rx->Size Bytes. 
+		Half transfer:   Strm_DmaPos(Rx, Rx->Size / 2); 
+		Transfer done:   Strm_DmaPos(Rx, 0); 
+		Idle line:       Strm_DmaPos(Rx, Rx->Size - DMA1_Channel5->CNDTR); 
+	Writer, one shot DMA: 
+		u32 Len = Strm_WritePtr(Rx, &Ptr); 	// Start DMA on Ptr for up to Len Bytes, 
+		Strm_Commit(Rx, Done); 				// then publish what arrived. 
+	Reader: 
+		Strm_Wait(Rx, -1); 
+		u8 * Ptr; 
+		u32 Len = Strm_ReadPtr(Rx, (void **)&Ptr); 	// Contiguous, no copy. 
+		Parse(Ptr, Len); 
+		Strm_Release(Rx, Len); 
+
+	With circular DMA the writer cannot be held off, a reader falling a whole ring behind 
+	loses data silently; the other writers drop the bytes that do not fit and count them in Drops. 
+*/
+#include <OS.h> 
+
+STREAM Strm_Create(u32 Size, u32 Trigger){ 	// Create a stream and its ring in one allocation. Size must be a power of 2. 
+	STREAM Strm = (STREAM)Lin_MemAlloc(((sizeof(Strm_Blk) + 7) & ~7) + Size); 
+	if(Strm == NULL) return NULL; 
+	Strm_Init(Strm, (u8 *)Strm + ((sizeof(Strm_Blk) + 7) & ~7), Size, Trigger); 
+	Strm->Owned = 1; 
+	return Strm; 
+}
+
+void Strm_Init(STREAM Strm, void * Buf, u32 Size, u32 Trigger){ 	// Build a stream over a caller supplied ring. 
+	Strm->Buf = (u8 *)Buf; 
+	Strm->Size = Size; 
+	Strm->Head = 0; 
+	Strm->Tail = 0; 
+	Strm->Reader = NULL; 
+	Strm->Drops = 0; 
+	Strm->Owned = 0; 
+	Strm_SetTrigger(Strm, Trigger); 
+}
+
+void Strm_Destroy(STREAM Strm){ 
+	if(Strm->Owned) Lin_MemFree(Strm); 
+}
+
+void Strm_SetTrigger(STREAM Strm, u32 Trigger){ 	// Clamped to 1..Size. 
+	if(Trigger == 0) Trigger = 1; 
+	if(Trigger > Strm->Size) Trigger = Strm->Size; 
+	Strm->Trigger = Trigger; 
+}
+
+// Wake the reader if it waits and the trigger level is reached. 
+static void Strm_Notify(STREAM Strm){ 
+	TASK Task = Strm->Reader; 
+	if(Task == NULL || Strm->Head - Strm->Tail < Strm->Trigger) return; 
+	Strm->Reader = NULL; 
+	OS_GenEvent(Task, 0); 
+}
+
+u32 Strm_Write(STREAM Strm, const void * Data, u32 Len){ 	// Copy in as much as fits. Returns the Bytes taken. 
+	u32 Head = Strm->Head; 
+	u32 Space = Strm->Size - (Head - Strm->Tail); 
+	if(Len > Space){ 
+		Strm->Drops += Len - Space; 
+		Len = Space; 
+	}
+	const u8 * Src = (const u8 *)Data; 
+	u32 Ofs = Head & (Strm->Size - 1); 
+	u32 First = Strm->Size - Ofs; 	// Up to the end of the ring, then wrap. 
+	if(First > Len) First = Len; 
+	for(u32 i = 0; i < First; i++) Strm->Buf[Ofs + i] = Src[i]; 
+	for(u32 i = First; i < Len; i++) Strm->Buf[i - First] = Src[i]; 
+	Strm->Head = Head + Len; 
+	Strm_Notify(Strm); 
+	return Len; 
+}
+
+u32 Strm_WritePtr(STREAM Strm, void ** Ptr){ 	// The contiguous free region, returns its length. 
+	u32 Head = Strm->Head; 
+	u32 Ofs = Head & (Strm->Size - 1); 
+	u32 Len = Strm->Size - (Head - Strm->Tail); 
+	if(Len > Strm->Size - Ofs) Len = Strm->Size - Ofs; 
+	*Ptr = Strm->Buf + Ofs; 
+	return Len; 
+}
+
+void Strm_Commit(STREAM Strm, u32 Len){ 	// Publish Len Bytes placed through Strm_WritePtr. 
+	Strm->Head = Strm->Head + Len; 
+	Strm_Notify(Strm); 
+}
+
+void Strm_DmaPos(STREAM Strm, u32 Pos){ 	// Circular DMA has filled the ring up to offset Pos. 
+	u32 Head = Strm->Head; 
+	u32 Len = (Pos - Head) & (Strm->Size - 1); 
+	if(Len == 0) return; 
+	u32 Used = Head - Strm->Tail; 
+	u32 Space = (Used < Strm->Size) ? Strm->Size - Used : 0; 
+	if(Len > Space) Strm->Drops += Len - Space; 	// Overrun: the oldest unread Bytes are already overwritten. 
+	Strm->Head = Head + Len; 
+	Strm_Notify(Strm); 
+}
+
+u32 Strm_ReadPtr(STREAM Strm, void ** Ptr){ 	// The contiguous readable region, returns its length. 
+	u32 Tail = Strm->Tail; 
+	u32 Ofs = Tail & (Strm->Size - 1); 
+	u32 Len = Strm->Head - Tail; 
+	if(Len > Strm->Size){ 	// Overrun by circular DMA, skip to the oldest valid Byte. 
+		Tail = Strm->Head - Strm->Size; 
+		Strm->Tail = Tail; 
+		Ofs = Tail & (Strm->Size - 1); 
+		Len = Strm->Size; 
+	}
+	if(Len > Strm->Size - Ofs) Len = Strm->Size - Ofs; 
+	*Ptr = Strm->Buf + Ofs; 
+	return Len; 
+}
+
+void Strm_Release(STREAM Strm, u32 Len){ 	// Drop Len Bytes obtained through Strm_ReadPtr. 
+	Strm->Tail = Strm->Tail + Len; 
+}
+
+u32 Strm_Read(STREAM Strm, void * Data, u32 Max){ 	// Copy out up to Max Bytes. Returns the Bytes read. 
+	u8 * Dst = (u8 *)Data; 
+	u32 Cnt = 0; 
+	while(Cnt < Max){ 	// At most twice, across the wrap. 
+		u8 * Ptr; 
+		u32 Len = Strm_ReadPtr(Strm, (void **)&Ptr); 
+		if(Len == 0) break; 
+		if(Len > Max - Cnt) Len = Max - Cnt; 
+		for(u32 i = 0; i < Len; i++) Dst[Cnt + i] = Ptr[i]; 
+		Strm_Release(Strm, Len); 
+		Cnt += Len; 
+	}
+	return Cnt; 
+}
+
+u32 Strm_Wait(STREAM Strm, int Timeout){ 	// Block until Trigger Bytes are buffered or Timeout ms pass, < 0 waits forever. 
+	// Returns the Bytes buffered, which is below Trigger on timeout. Tasks only. 
+	TASK Self = Lin_GetCurrTask(); 
+	u32 Deadline = TickCount + Timeout; 
+	while(Strm->Head - Strm->Tail < Strm->Trigger){ 
+		Strm->Reader = Self; 
+		if(Strm->Head - Strm->Tail >= Strm->Trigger) break; 	// Arrived meanwhile. 
+		int Left = Timeout; 
+		if(Timeout >= 0){ 	// Only what is left of the deadline, trickling data must not restart it. 
+			Left = (s32)(Deadline - TickCount); 
+			if(Left < 0) Left = 0; 
+		}
+		if(OS_WaitAny(NULL, 0, Left) == Src_TBG) break; 
+	}
+	Strm->Reader = NULL; 
+	return Strm->Head - Strm->Tail; 
+}
+
+// End of file. 
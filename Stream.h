@@ -0,0 +1,39 @@
+// Byte Stream Buffers version 0.1.1 header file 
+#ifndef __Stream_H__ 
+#define __Stream_H__ 
+
+// Stream Type - STREAM 
+typedef struct Strm_Blk{ 
+	u8 * Buf; 
+	u32 Size; 				// Power of 2 
+	volatile u32 Head; 	// Free running, advanced by the writer only 
+	volatile u32 Tail; 	// Free running, advanced by the reader only 
+	u32 Trigger; 			// Bytes that wake the reader 
+	TASK volatile Reader; 	// Parked in Strm_Wait 
+	u32 Drops; 				// Bytes lost for lack of room 
+	int Owned; 				// Buffer comes from Strm_Create 
+}Strm_Blk, * STREAM; 
+
+STREAM Strm_Create(u32 Size, u32 Trigger); 
+void   Strm_Init(STREAM Strm, void * Buf, u32 Size, u32 Trigger); 
+void   Strm_Destroy(STREAM Strm); 
+void   Strm_SetTrigger(STREAM Strm, u32 Trigger); 
+
+// Writer side, ISR safe 
+u32    Strm_Write(STREAM Strm, const void * Data, u32 Len); 
+u32    Strm_WritePtr(STREAM Strm, void ** Ptr); 
+void   Strm_Commit(STREAM Strm, u32 Len); 
+void   Strm_DmaPos(STREAM Strm, u32 Pos); 
+
+// Reader side 
+u32    Strm_ReadPtr(STREAM Strm, void ** Ptr); 
+void   Strm_Release(STREAM Strm, u32 Len); 
+u32    Strm_Read(STREAM Strm, void * Data, u32 Max); 
+u32    Strm_Wait(STREAM Strm, int Timeout); 
+
+#define Strm_Count(strm) ((strm)->Head - (strm)->Tail) 
+#define Strm_Space(strm) ((strm)->Size - Strm_Count(strm)) 
+
+#endif 
+
+// End of file. 
@@ -0,0 +1,151 @@
+// Software Timer Service version 0.1.1 
+/* Release Notes: 
+
+		<0.1.1 > 261019 A timer stopped or deleted by an earlier callback of the same batch no longer fires. 
+										Deleting a due timer defers its return to the pool until the batch is done. 
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	Timers replace tasks whose only job is a short periodic or delayed callback. 
+	They come from a fixed pool and are kept in a list sorted by expiry. 
+	One timer task, started by Tmr_Init at Tmr_TaskPri, sleeps on its TBG until the 
+	earliest expiry, then runs every callback due in one batch. 
+	Callbacks run on the timer task stack and must not block. 
+	A callback may stop or delete any timer, its own included. Stopped or deleted timers 
+	still in the batch are skipped, and a deleted one is not reused before the batch ends. 
+	All stamps are TickCount values compared wrap-safely. 
+*/
+#include <OS.h> 
+
+Tmr_Blk Tmr_Pool[Tmr_PoolSize]; 
+TIMER Tmr_FreeList; 	// Unused timers 
+TIMER Tmr_Active; 		// Armed timers, earliest first 
+TASK  Tmr_TaskRef; 		// The timer task 
+
+void Tmr_Task(TASK Self); 
+
+TASK Tmr_Init(void){ 	// Set up the pool and start the timer task. 
+	Tmr_FreeList = NULL; 
+	Tmr_Active = NULL; 
+	for(int i = Tmr_PoolSize - 1; i >= 0; i--){ 
+		Tmr_Pool[i].State = Tmr_Free; 
+		Tmr_Pool[i].Next = Tmr_FreeList; 
+		Tmr_FreeList = &Tmr_Pool[i]; 
+	}
+	Tmr_TaskRef = OS_New(Tmr_StkSize, Tmr_Task); 
+	if(Tmr_TaskRef == NULL) return NULL; 
+	Tmr_TaskRef->Priority = Tmr_TaskPri; 
+	OS_GenEvent(Tmr_TaskRef, 0); 
+	return Tmr_TaskRef; 
+}
+
+TIMER Tmr_New(void (*Func)(void * Arg), void * Arg){ 	// Returns NULL when the pool is exhausted. 
+	__critical_enter(); 
+	TIMER Tmr = Tmr_FreeList; 
+	if(Tmr != NULL){ 
+		Tmr_FreeList = Tmr->Next; 
+		Tmr->Next = NULL; 
+		Tmr->Func = Func; 
+		Tmr->Arg = Arg; 
+		Tmr->Period = 0; 
+		Tmr->State = Tmr_Idle; 
+	}
+	__critical_exit(); 
+	return Tmr; 
+}
+
+void Tmr_Unlink(TIMER Tmr){ 	// Remove from the active list. Critical region held by the caller. 
+	TIMER * Link = &Tmr_Active; 
+	while(*Link != NULL && *Link != Tmr) Link = &(*Link)->Next; 
+	if(*Link != NULL) *Link = Tmr->Next; 
+	Tmr->Next = NULL; 
+}
+
+void Tmr_Del(TIMER Tmr){ 
+	__critical_enter(); 
+	if(Tmr->State == Tmr_Firing){ 	// Still referenced by the batch, the timer task frees it. 
+		Tmr->State = Tmr_Dead; 
+		__critical_exit(); 
+		return; 
+	}
+	if(Tmr->State == Tmr_Armed) Tmr_Unlink(Tmr); 
+	Tmr->State = Tmr_Free; 
+	Tmr->Next = Tmr_FreeList; 
+	Tmr_FreeList = Tmr; 
+	__critical_exit(); 
+}
+
+void Tmr_StartAt(TIMER Tmr, u32 Stamp, u32 Period){ 	// Fire at TickCount == Stamp, then every Period ms if Period > 0. 
+	__critical_enter(); 
+	if(Tmr->State == Tmr_Armed) Tmr_Unlink(Tmr); 
+	Tmr->Stamp = Stamp; 
+	Tmr->Period = Period; 
+	Tmr->State = Tmr_Armed; 
+	TIMER * Link = &Tmr_Active; 
+	while(*Link != NULL && (s32)((*Link)->Stamp - Stamp) <= 0) Link = &(*Link)->Next; 
+	Tmr->Next = *Link; 
+	*Link = Tmr; 
+	int NewHead = (Tmr_Active == Tmr); 
+	__critical_exit(); 
+	if(NewHead) OS_GenEvent(Tmr_TaskRef, 0); 	// Earlier than what the timer task sleeps for. 
+}
+
+void Tmr_Start(TIMER Tmr, u32 Delay, u32 Period){ 	// Fire in Delay ms, then every Period ms if Period > 0. 
+	Tmr_StartAt(Tmr, TickCount + Delay, Period); 
+}
+
+void Tmr_Stop(TIMER Tmr){ 
+	__critical_enter(); 
+	if(Tmr->State == Tmr_Armed) Tmr_Unlink(Tmr); 
+	if(Tmr->State == Tmr_Armed || Tmr->State == Tmr_Firing) Tmr->State = Tmr_Idle; 	// A due timer is skipped. 
+	__critical_exit(); 
+}
+
+void Tmr_Task(TASK Self){ 	// Timer task. 
+	TIMER Due[Tmr_PoolSize]; 
+	for(;;){ 
+		int N = 0; 
+		__critical_enter(); 	// I. Take every timer due. 
+		while(Tmr_Active != NULL && (s32)(Tmr_Active->Stamp - TickCount) <= 0){ 
+			TIMER Tmr = Tmr_Active; 
+			Tmr_Active = Tmr->Next; 
+			Tmr->Next = NULL; 
+			Tmr->State = Tmr_Firing; 
+			Due[N++] = Tmr; 
+		}
+		__critical_exit(); 
+		for(int i = 0; i < N; i++){ 	// II. Run the batch, then re-arm the periodic ones left untouched by the callbacks. 
+			TIMER Tmr = Due[i]; 
+			__critical_reenter(); 
+			int Run = (Tmr->State == Tmr_Firing); 	// Not stopped, deleted or restarted by an earlier callback. 
+			__critical_exit(); 
+			if(Run) Tmr->Func(Tmr->Arg); 
+			__critical_reenter(); 
+			if(Tmr->State == Tmr_Dead){ 
+				Tmr->State = Tmr_Free; 
+				Tmr->Next = Tmr_FreeList; 
+				Tmr_FreeList = Tmr; 
+			}
+			else if(Tmr->State == Tmr_Firing){ 
+				if(Tmr->Period == 0) Tmr->State = Tmr_Idle; 
+				else{ 
+					u32 Stamp = Tmr->Stamp + Tmr->Period; 	// Drift free, but skip the periods already missed. 
+					if((s32)(Stamp - TickCount) <= 0) Stamp += ((TickCount - Stamp) / Tmr->Period + 1) * Tmr->Period; 
+					Tmr->State = Tmr_Idle; 
+					Tmr_StartAt(Tmr, Stamp, Tmr->Period); 
+				}
+			}
+			__critical_exit(); 
+		}
+		__critical_reenter(); 	// III. Sleep until the earliest expiry. 
+		if(Tmr_Active == NULL) OS_TBGstop(); 
+		else{ 
+			s32 Time = (s32)(Tmr_Active->Stamp - TickCount); 
+			OS_TBGdelay(Time > 0 ? Time : 0); 
+		}
+		__critical_exit(); 
+		OS_Suspend(); 
+	}
+}
+
+// End of file. 
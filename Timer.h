@@ -0,0 +1,36 @@
+// Software Timer Service version 0.1.1 header file 
+#ifndef __Timer_H__ 
+#define __Timer_H__ 
+
+// Configuration 
+#define Tmr_PoolSize 	16 		// Timers available 
+#define Tmr_StkSize 	1024 	// Stack of the timer task, callbacks run on it 
+#define Tmr_TaskPri 	-1 		// Priority of the timer task, above default tasks 
+
+#define Tmr_Free 	-1 	// In the pool 
+#define Tmr_Idle 	0 	// Allocated, not running 
+#define Tmr_Armed 	1 	// In the active list 
+#define Tmr_Firing 	2 	// Callback due or running 
+#define Tmr_Dead 	-2 	// Deleted while due, back to the pool after the batch 
+
+// Timer Type - TIMER 
+typedef struct Tmr_Blk{ 
+	struct Tmr_Blk * Next; 	// In the active list or the pool 
+	u32 Stamp; 				// Expiry in TickCount 
+	u32 Period; 			// 0 for one-shot 
+	int State; 
+	void (*Func)(void * Arg); 
+	void * Arg; 
+}Tmr_Blk, * TIMER; 
+
+TASK  Tmr_Init(void); 
+
+TIMER Tmr_New(void (*Func)(void * Arg), void * Arg); 
+void  Tmr_Del(TIMER Tmr); 
+void  Tmr_Start(TIMER Tmr, u32 Delay, u32 Period); 
+void  Tmr_StartAt(TIMER Tmr, u32 Stamp, u32 Period); 
+void  Tmr_Stop(TIMER Tmr); 
+
+#endif 
+
+// End of file. 
@@ -0,0 +1,176 @@
+// Publish/Subscribe Topics version 0.2.0 
+/* Release Notes: 
+
+		<0.2.0 > 261019 Pub snapshots the subscribers and delivers one at a time, each in its own short critical region. 
+										Added Purge, called by OS_Del, so deleted tasks leave every topic. At most Topic_SubMax subscribers. 
+		<0.1.1 > 261019 Messages carry Topic_Src, so OS releases the payload of one dropped by Tx_Over. 
+		<0.1.0 > 261019 Initial Release. 
+*/
+/* Comments: 
+	A Topic fans one payload out to all of its subscribers. 
+	Payloads come from a pool reserved with the topic and are reference counted: 
+	publishing enqueues one Carrier per subscriber, all pointing at the same payload, 
+	and the payload returns to the pool when the last receiver releases it. 
+
+	Publisher: 
+		Sample * S = Topic_Alloc(Topic); 
+		if(S != NULL){ 		// Pool exhausted otherwise. 
+			S->Value = ...; 
+			Topic_Pub(Topic, S); 
+		}
+	Subscriber: 
+		MSG Msg = OS_RxMsg(); 
+		if(Msg.Cmd == TopicCmd){ 
+			Use(Msg.Pld); 
+			Topic_Release(Msg.Pld); 
+		}
+
+	Topic_Pub copies the subscribers under the lock and delivers outside it, so interrupts are 
+	only masked for one delivery at a time. A subscriber that leaves meanwhile, by Topic_UnSub 
+	or by being deleted, bumps Gen, and a delivery then first checks it is still subscribed. 
+*/
+#include <OS.h> 
+
+TOPIC Topic_All; 	// Every topic, for Topic_Purge 
+
+TOPIC Topic_New(u32 Cmd, u32 PldSize, u32 PldCnt){ 	// Create a topic and its payload pool in one allocation. 
+	u32 BlkSize = sizeof(Topic_PldBlk) + ((PldSize + 7) & ~7); 
+	TOPIC Topic = (TOPIC)Lin_MemAlloc(((sizeof(Topic_Blk) + 7) & ~7) + BlkSize * PldCnt); 
+	if(Topic == NULL) return NULL; 
+	Topic->Cmd = Cmd; 
+	Topic->PldSize = PldSize; 
+	Topic->Subs = NULL; 
+	Topic->SubCnt = 0; 
+	Topic->Free = NULL; 
+	Topic->Drops = 0; 
+	Topic->Gen = 0; 
+	u8 * Blk = (u8 *)Topic + ((sizeof(Topic_Blk) + 7) & ~7); 
+	for(u32 i = 0; i < PldCnt; i++){ 
+		Topic_PldBlk * Pld = (Topic_PldBlk *)Blk; 
+		Pld->Topic = Topic; 
+		Pld->RefCnt = 0; 
+		Pld->Next = Topic->Free; 
+		Topic->Free = Pld; 
+		Blk += BlkSize; 
+	}
+	__critical_enter(); 
+	Topic->Next = Topic_All; 
+	Topic_All = Topic; 
+	__critical_exit(); 
+	return Topic; 
+}
+
+int Topic_Sub(TOPIC Topic, TASK Task){ 	// Subscribe a task, NULL for the current one. Returns -1 past Topic_SubMax. 
+	if(Task == NULL) Task = Lin_GetCurrTask(); 
+	Topic_SubBlk * Sub = (Topic_SubBlk *)Lin_MemAlloc(sizeof(Topic_SubBlk)); 
+	if(Sub == NULL) return -1; 
+	Sub->Task = Task; 
+	__critical_enter(); 
+	if(Topic->SubCnt >= Topic_SubMax){ 
+		__critical_exit(); 
+		Lin_MemFree(Sub); 
+		return -1; 
+	}
+	Sub->Next = Topic->Subs; 
+	Topic->Subs = Sub; 
+	Topic->SubCnt++; 
+	__critical_exit(); 
+	return 0; 
+}
+
+int Topic_UnSub(TOPIC Topic, TASK Task){ 	// Unsubscribe a task, NULL for the current one. Payloads already delivered stay valid. 
+	if(Task == NULL) Task = Lin_GetCurrTask(); 
+	__critical_enter(); 
+	Topic_SubBlk ** Link = &Topic->Subs; 
+	while(*Link != NULL && (*Link)->Task != Task) Link = &(*Link)->Next; 
+	Topic_SubBlk * Sub = *Link; 
+	if(Sub != NULL){ 
+		*Link = Sub->Next; 
+		Topic->SubCnt--; 
+		Topic->Gen++; 
+	}
+	__critical_exit(); 
+	if(Sub == NULL) return -1; 
+	Lin_MemFree(Sub); 
+	return 0; 
+}
+
+void Topic_Purge(TASK Task){ 	// Remove a task from every topic. Called by OS_Del, in its critical region. 
+	__critical_enter(); 
+	for(TOPIC Topic = Topic_All; Topic != NULL; Topic = Topic->Next){ 
+		Topic_SubBlk ** Link = &Topic->Subs; 
+		while(*Link != NULL){ 
+			Topic_SubBlk * Sub = *Link; 
+			if(Sub->Task != Task){ 
+				Link = &Sub->Next; 
+				continue; 
+			}
+			*Link = Sub->Next; 
+			Topic->SubCnt--; 
+			Topic->Gen++; 
+			Lin_MemFree(Sub); 
+		}
+	}
+	__critical_exit(); 
+}
+
+void * Topic_Alloc(TOPIC Topic){ 	// Get a payload to fill. Returns NULL when the pool is exhausted. 
+	__critical_enter(); 
+	Topic_PldBlk * Pld = Topic->Free; 
+	if(Pld != NULL) Topic->Free = Pld->Next; 
+	__critical_exit(); 
+	if(Pld == NULL) return NULL; 
+	Pld->RefCnt = 0; 
+	return Pld + 1; 
+}
+
+int Topic_Pub(TOPIC Topic, void * Data){ 	// Deliver a payload to every subscriber and wake them up. Returns the number reached. Full mailboxes are skipped. 
+	Topic_PldBlk * Pld = (Topic_PldBlk *)Data - 1; 
+	TASK Task[Topic_SubMax]; 
+	MSG Msg; 
+	Msg.Src = Topic_Src; 
+	Msg.Cmd = Topic->Cmd; 
+	Msg.Pld = Data; 
+	int N = 0; 
+	int Cnt = 0; 
+	__critical_enter(); 	// I. Snapshot the subscribers. 
+	for(Topic_SubBlk * Sub = Topic->Subs; Sub != NULL && N < Topic_SubMax; Sub = Sub->Next) Task[N++] = Sub->Task; 
+	u32 Gen = Topic->Gen; 
+	Pld->RefCnt = N + 1; 	// Counted up front, a receiver may release before we finish. One is ours. 
+	__critical_exit(); 
+	for(int i = 0; i < N; i++){ 	// II. Deliver, one short region each. 
+		__critical_reenter(); 
+		int Live = 1; 
+		if(Topic->Gen != Gen){ 	// Someone left, make sure this one is still there. 
+			Topic_SubBlk * Sub = Topic->Subs; 
+			while(Sub != NULL && Sub->Task != Task[i]) Sub = Sub->Next; 
+			Live = (Sub != NULL); 
+		}
+		int Sent = Live && OS_TxMsgEx(Task[i], Msg, Tx_Fail) == 0; 
+		if(Sent) OS_GenEvent(Task[i], 0); 
+		else if(Live) Topic->Drops++; 	// Full or out of carriers. 
+		__critical_exit(); 
+		if(Sent) Cnt++; 
+		else Topic_Release(Data); 
+	}
+	Topic_Release(Data); 	// Ours, returns the payload if nobody got it. 
+	return Cnt; 
+}
+
+void Topic_Release(void * Data){ 	// Drop one reference. The last one returns the payload to its pool. 
+	Topic_PldBlk * Pld = (Topic_PldBlk *)Data - 1; 
+	__critical_enter(); 
+	if(--Pld->RefCnt <= 0){ 
+		TOPIC Topic = Pld->Topic; 
+		Pld->RefCnt = 0; 
+		Pld->Next = Topic->Free; 
+		Topic->Free = Pld; 
+	}
+	__critical_exit(); 
+}
+
+TOPIC Topic_Of(void * Data){ 	// The topic a payload belongs to. 
+	return ((Topic_PldBlk *)Data - 1)->Topic; 
+}
+
+// End of file. 
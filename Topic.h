@@ -0,0 +1,47 @@
+// Publish/Subscribe Topics version 0.2.0 header file 
+#ifndef __Topic_H__ 
+#define __Topic_H__ 
+
+#define Topic_SubMax 	16 			// Subscribers per topic 
+#define Topic_Src 	0x546F7063 	// Src of the Messages carrying payloads, lets a dropped one be released 
+
+// Subscriber Node !!Internal 
+typedef struct Topic_SubBlk{ 
+	struct Topic_SubBlk * Next; 
+	TASK Task; 
+}Topic_SubBlk; 
+
+// Shared Payload Header !!Internal, the payload data follows it. 
+typedef struct Topic_PldBlk{ 
+	struct Topic_Blk * Topic; 
+	struct Topic_PldBlk * Next; 	// In the free list 
+	int RefCnt; 				// Receivers yet to release 
+	int Rsvd; 
+}Topic_PldBlk; 
+
+// Topic Type - TOPIC 
+typedef struct Topic_Blk{ 
+	u32 Cmd; 			// Cmd of the carried Messages 
+	u32 PldSize; 		// Payload size in Bytes 
+	Topic_SubBlk * Subs; 
+	int SubCnt; 
+	Topic_PldBlk * Free; 	// Payload pool 
+	u32 Drops; 			// Deliveries lost for lack of Carriers 
+	u32 Gen; 			// Bumped whenever a subscriber leaves 
+	struct Topic_Blk * Next; 	// In the list of all topics 
+}Topic_Blk, * TOPIC; 
+
+TOPIC Topic_New(u32 Cmd, u32 PldSize, u32 PldCnt); 
+int   Topic_Sub(TOPIC Topic, TASK Task); 
+int   Topic_UnSub(TOPIC Topic, TASK Task); 
+void  Topic_Purge(TASK Task); 
+extern TOPIC Topic_All; 
+
+void * Topic_Alloc(TOPIC Topic); 
+int    Topic_Pub(TOPIC Topic, void * Pld); 
+void   Topic_Release(void * Pld); 
+TOPIC  Topic_Of(void * Pld); 
+
+#endif 
+
+// End of file. 
@@ -1,93 +1,221 @@
-// lyrinka OS startup code version 0.2.1 
-// Contains main function, scheduler thread and system timer functions 
-// This piece of code is to be executed, not referenced by external code. 
-/* Release Notes: 
-
-			<0.3.0 > 190301 Minor changes adapting new Lin library. 
-			<0.2.1 > 190228 Added low power option. 
-			<0.2.0 > 190208 Added support for another type of suspend requests. 
-			<0.1.1 > 190206 Refined error procedures on empty waiting lists. 
-			<0.1.0 > 190204 Initial Release. 
-*/
-#include <stm32f10x.h> 
-#include <OS.h> 
-
-u32 TickCount; 
-
-// Internal Functions 
-int GetSus(TASK * Task){ 
-	if(Lin_MsgQty() == 0){ 
-		*Task = NULL; 
-		return 0; 
-	}
-	MSG Msg = Lin_MsgRecv(); 
-	*Task = Msg.Pld; 
-	return (Msg.Cmd != 0); 
-}
-
-// Handlers & System Code 
-void SysTick_Init(u32 Time){ 
-	__critical_enter(); 
-	TickCount = 0; 
-	SysTick->CTRL = 0x0; 
-	SysTick->LOAD = Time - 1; 
-	SysTick->VAL = 0; 
-	SCB->SHP[12+SysTick_IRQn] = 0x0; // Highest priority 
-	SysTick->CTRL = 0x3; 
-	__critical_exit(); 
-}
-
-void SysTick_Handler(void){ 
-	TickCount++; 
-	Lin_YieldISR(); 
-	return; 
-}
-
-// Main Function 
-extern void OS_Scheduler(TASK Self); 
-int main(void){ 
-	Lin_Init(); 
-	TASK OS = Lin_New(1024, OS_Scheduler); 
-	Lin_Enter(OS); 
-	Lin_Delete(OS); 
-	__disable_irq(); 	
-	while(1); 
-}
-
-
-// System Idle Processes 
-void SIP(void){ 
-	static long long a = -1; 
-	a++; 
-#ifdef LPW 
-	__WFI(); 
-#endif 
-}
-
-// Scheduler Process (main task) 
-extern void mainTask(TASK Self); 
-void OS_Scheduler(TASK Self){ 
-	Sched_Init(Self); 
-	Ev_Init(); 
-	TASK Task; 
-	
-	Task = OS_New(2048, mainTask); 
-	OS_GenEvent(Task, 0); 
-	
-	Task = OS_New(512, SIP); 
-	Task->Priority = 0x7FFFFFFF; 
-	OS_GenEvent(Task, 0); 
-	
-	SysTick_Init(9000); 
-	for(;;){ 
-		Task = Sched_Do(TickCount, Ev_Query, Ev_Cycle, GetSus); 
-		if(Task == NULL){ 
-			__critical_enter(); 
-			__BKPT(0xE8); 
-			__nop(); 
-		}
-		Lin_Switch(Task); 
-	}
-}
-
-// End of file. 
+// lyrinka OS startup code version 0.8.2 
+// Contains main function, scheduler thread and system timer functions 
+// This piece of code is to be executed, not referenced by external code. 
+/* Release Notes: 
+
+			<0.8.2 > 261019 SIM counts down TimeSlices for every virtual ms crossed, as SysTick does. 
+			<0.8.1 > 261019 SIM idle passes close their load interval, idle time no longer counts as kernel time. 
+			<0.8.0 > 261019 Added the SIM option: virtual time that jumps to the next TBG stamp when only SIP is ready. 
+			<0.7.0 > 261019 SysTick only yields to the scheduler when Sched_TickCheck finds a pass due. 
+			<0.6.0 > 261019 Scheduler passes feed the CPU load monitor. SIP no longer counts on its own. 
+			<0.5.0 > 261019 Added the 64-bit microsecond timebase and the HRT option for sub-millisecond TBG deadlines. 
+			<0.4.0 > 261019 Starts the software timer task. 
+			<0.3.0 > 190301 Minor changes adapting new Lin library. 
+			<0.2.1 > 190228 Added low power option. 
+			<0.2.0 > 190208 Added support for another type of suspend requests. 
+			<0.1.1 > 190206 Refined error procedures on empty waiting lists. 
+			<0.1.0 > 190204 Initial Release. 
+*/
+#include <stm32f10x.h> 
+#include <OS.h> 
+
+u32 TickCount; 
+u32 TickCountHi; 	// Wraps of TickCount, for the 64-bit timebase 
+
+// Internal Functions 
+int GetSus(TASK * Task){ 
+	if(Lin_MsgQty() == 0){ 
+		*Task = NULL; 
+		return 0; 
+	}
+	MSG Msg = Lin_MsgRecv(); 
+	*Task = Msg.Pld; 
+	return (Msg.Cmd != 0); 
+}
+
+#ifdef SIM 
+// Simulation: time is virtual and only moves through the scheduler. 
+// Each pass running a task costs Sim_PassUs, and when only SIP is ready 
+// time jumps straight to the earliest TBG stamp. There is no SysTick: Sim_Advance 
+// does its TimeSlice work for every ms crossed, so equal priorities still rotate. 
+// Nothing preempts a task though, it runs until it blocks or yields and a used up 
+// TimeSlice only takes effect at the next pass. A run only depends on the seed of Sim_Rand. 
+// SIM is a build of the target firmware, to be run on the chip or in an emulator. 
+// Replaying a run on a Linux host is not provided, the tree has no host port. 
+unsigned long long Sim_TimeUs; 
+u32 Sim_RandState; 
+
+void Sim_Seed(u32 Seed){ 
+	Sim_RandState = Seed; 
+}
+
+u32 Sim_Rand(void){ 	// Linear congruential, the only source of randomness in a simulation. 
+	Sim_RandState = Sim_RandState * 1664525 + 1013904223; 
+	return Sim_RandState; 
+}
+
+void Sim_Advance(u32 Time){ 	// Move virtual time forward by Time us, doing the work of SysTick for every ms crossed. 
+	unsigned long long Tick = Sim_TimeUs / 1000; 
+	Sim_TimeUs += Time; 
+	unsigned long long End = Sim_TimeUs / 1000; 
+#if Sched_FastTick 
+	while(Tick < End) Sched_TickCheck((u32)(++Tick * 1000)); 	// Counts down the TimeSlice of Running. 
+#endif 
+	TickCount = (u32)End; 
+	TickCountHi = (u32)(End >> 32); 
+}
+
+void Sim_Idle(void){ 	// Nothing but SIP is ready: skip to the next TBG stamp, or a tick if there is none. 
+	s32 Time = 1000; 
+	if(Sched_NextValid) Time = (s32)(Sched_NextStamp - (u32)Sim_TimeUs); 
+	Sim_Advance(Time > 0 ? Time : 1); 
+}
+
+unsigned long long OS_TimeUs(void){ 
+	return Sim_TimeUs; 
+}
+#else 
+// Handlers & System Code 
+void SysTick_Init(u32 Time){ 
+	__critical_enter(); 
+	TickCount = 0; 
+	TickCountHi = 0; 
+	SysTick->CTRL = 0x0; 
+	SysTick->LOAD = Time - 1; 
+	SysTick->VAL = 0; 
+	SCB->SHP[12+SysTick_IRQn] = 0x0; // Highest priority 
+	SysTick->CTRL = 0x3; 
+	__critical_exit(); 
+}
+
+void SysTick_Handler(void){ 
+	if(++TickCount == 0) TickCountHi++; 
+#if Sched_FastTick 
+	if(Sched_TickCheck(OS_TimeStamp())) Lin_YieldISR(); 
+#else 
+	Lin_YieldISR(); 
+#endif 
+	return; 
+}
+
+// Microseconds since SysTick_Init, TickCount extended by the SysTick current value. 
+unsigned long long OS_TimeUs(void){ 
+	__critical_enter(); 
+	u32 Hi = TickCountHi; 
+	u32 Lo = TickCount; 
+	u32 Val = SysTick->VAL; 
+	if(SCB->ICSR & (1 << 26)){ 	// Reloaded, but SysTick_Handler not run yet. 
+		Val = SysTick->VAL; 
+		if(++Lo == 0) Hi++; 
+	}
+	u32 Load = SysTick->LOAD + 1; 
+	__critical_exit(); 
+	return (((unsigned long long)Hi << 32) | Lo) * 1000 + (unsigned long long)(Load - 1 - Val) * 1000 / Load; 
+}
+#endif 
+
+#if defined(HRT) && !defined(SIM) 
+// High Resolution TBG: TIM2 free-running at 1MHz, one compare-match for the nearest deadline 
+// inside the current millisecond. No interrupt unless such a deadline exists. 
+void HRT_Init(void){ 
+	RCC->APB1ENR |= RCC_APB1ENR_TIM2EN; 
+	TIM2->CR1 = 0; 
+	TIM2->PSC = SystemCoreClock / 1000000 - 1; 	// TIM2 clocked at SystemCoreClock with APB1 prescaled by 2 
+	TIM2->ARR = 0xFFFF; 
+	TIM2->EGR = TIM_EGR_UG; 
+	TIM2->SR = 0; 
+	TIM2->DIER = 0; 
+	NVIC_SetPriority(TIM2_IRQn, 0); 
+	NVIC_EnableIRQ(TIM2_IRQn); 
+	TIM2->CR1 = TIM_CR1_CEN; 
+}
+
+void HRT_Arm(void){ 	// Called after each pass, with the nearest stamp found by the scheduler. 
+	TIM2->DIER = 0; 
+	if(Sched_NextValid == 0) return; 
+	s32 Time = (s32)(Sched_NextStamp - OS_TimeStamp()); 
+	if(Time >= 1000) return; 	// SysTick comes first. 
+	if(Time < 1) Time = 1; 
+	TIM2->CCR1 = (u16)(TIM2->CNT + Time); 
+	TIM2->SR = ~TIM_SR_CC1IF; 
+	TIM2->DIER = TIM_DIER_CC1IE; 
+}
+
+void TIM2_IRQHandler(void){ 
+	TIM2->SR = ~TIM_SR_CC1IF; 
+	TIM2->DIER = 0; 
+	Lin_YieldISR(); 
+}
+#endif 
+
+
+// Main Function 
+extern void OS_Scheduler(TASK Self); 
+int main(void){ 
+	Lin_Init(); 
+	TASK OS = Lin_New(1024, OS_Scheduler); 
+	Lin_Enter(OS); 
+	Lin_Delete(OS); 
+	__disable_irq(); 	
+	while(1); 
+}
+
+
+// System Idle Processes 
+// Its cycles are accounted as idle by the load monitor. 
+void SIP(void){ 
+#ifdef LPW 
+	__WFI(); 
+#endif 
+}
+
+// Scheduler Process (main task) 
+extern void mainTask(TASK Self); 
+void OS_Scheduler(TASK Self){ 
+	Sched_Init(Self); 
+	Ev_Init(); 
+	Tmr_Init(); 
+	TASK Task; 
+	
+	Task = OS_New(2048, mainTask); 
+	OS_GenEvent(Task, 0); 
+	
+	Task = OS_New(512, SIP); 
+	Task->Priority = Sched_IdlePri; 
+	OS_GenEvent(Task, 0); 
+	Load_Init(Task); 
+	
+#ifdef SIM 
+	Sim_TimeUs = 0; 
+	Sim_Advance(0); 
+#else 
+	SysTick_Init(9000); 
+#endif 
+#if defined(HRT) && !defined(SIM) 
+	HRT_Init(); 
+#endif 
+	for(;;){ 
+		Load_Enter(); 
+		Task = Sched_Do(TickCount, OS_TimeStamp(), Ev_Query, Ev_Cycle, GetSus); 
+#if defined(HRT) && !defined(SIM) 
+		HRT_Arm(); 
+#endif 
+		if(Task == NULL){ 
+			__critical_enter(); 
+			__BKPT(0xE8); 
+			__nop(); 
+		}
+#ifdef SIM 
+		if(Task->Priority >= Sched_IdlePri){ 	// Never switch to SIP, nothing would bring us back. 
+			Load_Leave(Task); 	// The virtual wait belongs to SIP, not to the pass. 
+			Sim_Idle(); 
+			continue; 
+		}
+		Sim_Advance(Sim_PassUs); 
+#endif 
+		Load_Leave(Task); 
+		Lin_Switch(Task); 
+	}
+}
+
+// End of file. 
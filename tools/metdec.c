@@ -0,0 +1,122 @@
+// Kernel Metrics Decoder version 0.1.0 
+/* Comments: 
+	Host side decoder for the frames written by Met. 
+	Build: 	cc -o metdec metdec.c 
+	Usage: 	metdec [file] 	reads stdin without a file, e.g. a QEMU met.bin or an SWO capture. 
+	Frames with a bad sum are skipped, the decoder resyncs on the next A5 5A. 
+	Counters are printed as deltas and running totals, gauges and task fields as values. 
+*/
+#include <stdio.h> 
+#include <stdint.h> 
+#include <string.h> 
+
+#define MaxId 	256 
+
+char Name[MaxId][64]; 
+int  Kind[MaxId]; 
+long long Total[MaxId]; 
+unsigned Stamp; 
+
+int Var(const uint8_t * Buf, int Len, int * Pos, uint32_t * Value){ 
+	uint32_t V = 0; 
+	for(int Shift = 0; Shift < 35; Shift += 7){ 
+		if(*Pos >= Len) return -1; 
+		uint8_t B = Buf[(*Pos)++]; 
+		V |= (uint32_t)(B & 0x7F) << Shift; 
+		if((B & 0x80) == 0){ 
+			*Value = V; 
+			return 0; 
+		}
+	}
+	return -1; 
+}
+
+int32_t Zig(uint32_t V){ 
+	return (int32_t)(V >> 1) ^ -(int32_t)(V & 1); 
+}
+
+const char * NameOf(int Id){ 
+	return Name[Id][0] != 0 ? Name[Id] : "?"; 
+}
+
+void Frame(int Type, const uint8_t * Buf, int Len){ 
+	int Pos = 0; 
+	uint32_t V; 
+	switch(Type){ 
+		case 1: 	// Dict 
+			while(Pos + 2 < Len){ 
+				int Id = Buf[Pos++]; 
+				Kind[Id] = Buf[Pos++]; 
+				int N = 0; 
+				while(Pos < Len && Buf[Pos] != 0){ 
+					if(N < 63) Name[Id][N++] = Buf[Pos]; 
+					Pos++; 
+				}
+				Name[Id][N] = 0; 
+				Pos++; 
+			}
+			break; 
+		case 2: 	// Delta 
+			if(Var(Buf, Len, &Pos, &V) < 0) return; 
+			Stamp = V; 
+			while(Pos < Len){ 
+				int Id = Buf[Pos++]; 
+				if(Var(Buf, Len, &Pos, &V) < 0) return; 
+				if(Kind[Id] == 0){ 
+					Total[Id] += Zig(V); 
+					printf("%10u %-16s %+d (%lld)\n", Stamp, NameOf(Id), Zig(V), Total[Id]); 
+				}
+				else printf("%10u %-16s %d\n", Stamp, NameOf(Id), Zig(V)); 
+			}
+			break; 
+		case 3: 	// Task 
+			if(Var(Buf, Len, &Pos, &V) < 0) return; 
+			printf("%10u Task %08X", Stamp, V); 
+			while(Pos < Len){ 
+				int Id = Buf[Pos++]; 
+				uint32_t F; 
+				if(Var(Buf, Len, &Pos, &F) < 0) break; 
+				printf(" %s=%d", NameOf(Id), Zig(F)); 
+			}
+			printf("\n"); 
+			break; 
+	}
+}
+
+int main(int argc, char ** argv){ 
+	FILE * In = stdin; 
+	if(argc > 1 && (In = fopen(argv[1], "rb")) == NULL){ 
+		perror(argv[1]); 
+		return 1; 
+	}
+	static uint8_t Buf[4096]; 
+	int Prev = -1, C, Bad = 0; 
+	while((C = fgetc(In)) != EOF){ 
+		if(!(Prev == 0xA5 && C == 0x5A)){ 
+			Prev = C; 
+			continue; 
+		}
+		Prev = -1; 
+		int Type = fgetc(In); 
+		uint32_t Len = 0; 
+		int Shift = 0; 
+		do{ 
+			C = fgetc(In); 
+			Len |= (uint32_t)(C & 0x7F) << Shift; 
+			Shift += 7; 
+		}while(C != EOF && (C & 0x80) != 0 && Shift < 35); 
+		if(Type == EOF || C == EOF || Len > sizeof(Buf)) continue; 
+		if(fread(Buf, 1, Len, In) != Len || (C = fgetc(In)) == EOF) break; 
+		uint8_t Sum = 0; 
+		for(uint32_t i = 0; i < Len; i++) Sum += Buf[i]; 
+		if(Sum != (uint8_t)C){ 
+			Bad++; 
+			continue; 
+		}
+		Frame(Type, Buf, (int)Len); 
+	}
+	if(Bad > 0) fprintf(stderr, "%d frames dropped\n", Bad); 
+	return 0; 
+}
+
+// End of file. 